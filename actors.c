@@ -0,0 +1,106 @@
+#include <stdlib.h>
+#include "actors.h"
+
+void dc_Actors_init(dc_Actors* actors, unsigned int capacity) {
+  *actors = (dc_Actors){0};
+  dc_Actors_reserve(actors, capacity);
+}
+
+void dc_Actors_free(dc_Actors* actors) {
+  free(actors->slots);
+  free(actors->slot_of);
+  free(actors->position);
+  free(actors->velocity);
+  free(actors->time_until_next_frame);
+  free(actors->iframe_time_remaining);
+  free(actors->anim);
+  free(actors->health);
+  free(actors->collider);
+  free(actors->ai);
+  free(actors->should_be_freed);
+  free(actors->sprite);
+  *actors = (dc_Actors){0};
+}
+
+void dc_Actors_reserve(dc_Actors* actors, unsigned int capacity) {
+  if(capacity <= actors->capacity) return;
+  unsigned int old_capacity = actors->capacity;
+
+  actors->slots = realloc(actors->slots, sizeof(dc_ActorSlot) * capacity);
+  actors->slot_of = realloc(actors->slot_of, sizeof(unsigned int) * capacity);
+  actors->position = realloc(actors->position, sizeof(Vector2) * capacity);
+  actors->velocity = realloc(actors->velocity, sizeof(Vector2) * capacity);
+  actors->time_until_next_frame = realloc(actors->time_until_next_frame, sizeof(float) * capacity);
+  actors->iframe_time_remaining = realloc(actors->iframe_time_remaining, sizeof(float) * capacity);
+  actors->anim = realloc(actors->anim, sizeof(dc_Anim) * capacity);
+  actors->health = realloc(actors->health, sizeof(dc_Health) * capacity);
+  actors->collider = realloc(actors->collider, sizeof(dc_Collider) * capacity);
+  actors->ai = realloc(actors->ai, sizeof(dc_AiKind) * capacity);
+  actors->should_be_freed = realloc(actors->should_be_freed, sizeof(bool) * capacity);
+  actors->sprite = realloc(actors->sprite, sizeof(dc_Sprite) * capacity);
+
+  // the end of the free list was marked with old_capacity, which is now the first of the new
+  // slots, so chaining them in order appends them to whatever was already free
+  for(unsigned int s = old_capacity; s < capacity; s++) {
+    actors->slots[s].generation = 1;
+    actors->slots[s].next_free = s + 1;
+  }
+  actors->capacity = capacity;
+}
+
+dc_Handle dc_Actors_add(dc_Actors* actors, dc_Actor actor) {
+  if(actors->count >= actors->capacity) dc_Actors_reserve(actors, actors->capacity ? actors->capacity * 2 : 64);
+
+  unsigned int slot = actors->free_slot;
+  actors->free_slot = actors->slots[slot].next_free;
+  unsigned int a = actors->count++;
+  actors->slots[slot].dense = a;
+  actors->slot_of[a] = slot;
+
+  actors->position[a] = actor.position;
+  actors->velocity[a] = actor.velocity;
+  actors->time_until_next_frame[a] = actor.time_until_next_frame;
+  actors->iframe_time_remaining[a] = actor.iframe_time_remaining;
+  actors->anim[a] = actor.anim;
+  actors->health[a] = actor.health;
+  actors->collider[a] = actor.collider;
+  actors->ai[a] = actor.ai;
+  actors->should_be_freed[a] = false;
+  actors->sprite[a] = actor.sprite;
+  return (dc_Handle){slot, actors->slots[slot].generation};
+}
+
+void dc_Actors_swap_remove(dc_Actors* actors, unsigned int idx) {
+  unsigned int slot = actors->slot_of[idx];
+  if(++actors->slots[slot].generation == 0) actors->slots[slot].generation = 1;
+  actors->slots[slot].next_free = actors->free_slot;
+  actors->free_slot = slot;
+
+  unsigned int last = --actors->count;
+  if(idx != last) {
+    actors->slot_of[idx] = actors->slot_of[last];
+    actors->slots[actors->slot_of[idx]].dense = idx;
+    actors->position[idx] = actors->position[last];
+    actors->velocity[idx] = actors->velocity[last];
+    actors->time_until_next_frame[idx] = actors->time_until_next_frame[last];
+    actors->iframe_time_remaining[idx] = actors->iframe_time_remaining[last];
+    actors->anim[idx] = actors->anim[last];
+    actors->health[idx] = actors->health[last];
+    actors->collider[idx] = actors->collider[last];
+    actors->ai[idx] = actors->ai[last];
+    actors->should_be_freed[idx] = actors->should_be_freed[last];
+    actors->sprite[idx] = actors->sprite[last];
+  }
+}
+
+int dc_Actors_index(const dc_Actors* actors, dc_Handle handle) {
+  if(handle.generation == 0 || handle.slot >= actors->capacity) return -1;
+  const dc_ActorSlot* slot = &actors->slots[handle.slot];
+  if(slot->generation != handle.generation) return -1;
+  return slot->dense;
+}
+
+dc_Handle dc_Actors_handle(const dc_Actors* actors, unsigned int idx) {
+  unsigned int slot = actors->slot_of[idx];
+  return (dc_Handle){slot, actors->slots[slot].generation};
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "dc.h"
+
+typedef enum {
+  DC_AI_NONE = 0,
+  DC_AI_BAT
+} dc_AiKind;
+
+// only the draw pass reads this
+typedef struct {
+  dc_FrameSet frames;
+  Color color;
+  Vector2 origin;
+  float rotation;
+  bool has_shadow;
+  Vector2 shadow_offset;
+} dc_Sprite;
+
+typedef struct {
+  float time_per_frame;
+  unsigned int current_frame;
+  unsigned int frame_count;
+  bool free_on_anim_comp;
+} dc_Anim;
+
+typedef struct {
+  unsigned int layer;
+  unsigned int mask;
+  int damage;
+} dc_Collider;
+
+typedef struct {
+  int hp;
+  int hp_max;
+} dc_Health;
+
+// one actor's worth of components. this is just how an actor gets described before
+// it's added to dc_Actors, nothing keeps these around
+typedef struct {
+  Vector2 position;
+  Vector2 velocity;
+  float time_until_next_frame;
+  float iframe_time_remaining;
+  dc_Sprite sprite;
+  dc_Anim anim;
+  dc_Collider collider;
+  dc_Health health;
+  dc_AiKind ai;
+} dc_Actor;
+
+// a reference to an actor that stays valid while it moves around the packed arrays and
+// goes stale (instead of dangling) once it's removed. generation 0 is never handed out
+typedef struct {
+  unsigned int slot;
+  unsigned int generation;
+} dc_Handle;
+
+#define DC_HANDLE_NULL ((dc_Handle){0, 0})
+
+typedef struct {
+  unsigned int dense; // where the actor lives in the component arrays while the slot is in use
+  unsigned int generation;
+  unsigned int next_free;
+} dc_ActorSlot;
+
+// every live actor packed into [0, count) of each component array. removing an actor
+// moves the last one into its place, so passes just walk 0..count with no holes.
+// slots hand out handles from a free list, so adding and removing are both O(1)
+typedef struct {
+  unsigned int count;
+  unsigned int capacity;
+  dc_ActorSlot* slots; // capacity of them
+  unsigned int free_slot; // head of the free list, == capacity when empty
+  unsigned int* slot_of; // dense index -> slot
+  Vector2* position;
+  Vector2* velocity;
+  // the two per-step timers get arrays of their own so the kernels can tick them in bulk
+  float* time_until_next_frame;
+  float* iframe_time_remaining;
+  dc_Anim* anim;
+  dc_Health* health;
+  dc_Collider* collider;
+  dc_AiKind* ai;
+  bool* should_be_freed;
+  dc_Sprite* sprite;
+} dc_Actors;
+
+void dc_Actors_init(dc_Actors* actors, unsigned int capacity);
+void dc_Actors_free(dc_Actors* actors);
+// grows every array up front so adding that many actors later never hits the allocator
+void dc_Actors_reserve(dc_Actors* actors, unsigned int capacity);
+// doubles the capacity if it's full; the new actor always goes at index count-1
+dc_Handle dc_Actors_add(dc_Actors* actors, dc_Actor actor);
+// moves the last actor into idx and bumps the removed slot's generation
+void dc_Actors_swap_remove(dc_Actors* actors, unsigned int idx);
+// dense index for a handle, or -1 if it's stale or null
+int dc_Actors_index(const dc_Actors* actors, dc_Handle handle);
+dc_Handle dc_Actors_handle(const dc_Actors* actors, unsigned int idx);
@@ -0,0 +1,450 @@
+// scenario benchmarks over the headless sim. `make bench` runs them all and checks them against
+// bench_baseline.json, `make bench-baseline` records a new one. the timings in the committed one
+// are from whatever machine recorded it, re-record on yours before trusting its timing checks
+//   dc_bench [--threads N] [--kernels NAME] [--only NAME] [--out FILE] [--baseline FILE] [--threshold PCT]
+//   dc_bench --collision-stress | --kernel-bench | --snapshot-bench
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "dc.h"
+#include "sim.h"
+#include "kernels.h"
+#include "jobs.h"
+#include "snapshot.h"
+
+// every malloc/calloc/realloc our own code makes goes through these (the bench links with
+// -Wl,--wrap), which is how allocations per step get counted
+static unsigned long dc_bench_allocs;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  __atomic_add_fetch(&dc_bench_allocs, 1, __ATOMIC_RELAXED);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  __atomic_add_fetch(&dc_bench_allocs, 1, __ATOMIC_RELAXED);
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  __atomic_add_fetch(&dc_bench_allocs, 1, __ATOMIC_RELAXED);
+  return __real_realloc(ptr, size);
+}
+
+#define WARMUP_STEPS 60
+#define BENCH_RUNS 3 // each scenario keeps its fastest run, the slower ones are the machine being busy
+#define IMMORTAL_HP 1000000 // scenarios that aren't about dying keep the player around
+
+typedef struct {
+  const char* name;
+  unsigned int actors; // how many the setup spawns, on top of the starting room
+  unsigned long steps;
+  void (*setup)(dc_World* world, unsigned int actors);
+  dc_Input (*input)(const dc_World* world, unsigned long step);
+} dc_Scenario;
+
+typedef struct {
+  double ns_per_actor_step;
+  double ms_per_step;
+  double worst_entry_ms; // slowest step that walked into a room, the hitch you'd feel
+  double allocs_per_step;
+  unsigned long actor_steps;
+  unsigned long rooms_entered;
+} dc_ScenarioResult;
+
+static void dc_make_player_immortal(dc_World* world) {
+  int player = dc_World_player(world);
+  if(player >= 0) world->actors.health[player].hp = world->actors.health[player].hp_max = IMMORTAL_HP;
+}
+
+// a ring of bats around a player who stands still in the middle of the room
+static void dc_setup_homing(dc_World* world, unsigned int actors) {
+  dc_make_player_immortal(world);
+  Vector2 center = {TILE_WIDTH * 10, TILE_HEIGHT * 4.2};
+  for(unsigned int b = 0; b < actors; b++) {
+    float angle = b * (2 * PI / actors);
+    Vector2 pos = {center.x + cosf(angle) * TILE_WIDTH * 8, center.y + sinf(angle) * TILE_HEIGHT * 1.4};
+    dc_Actors_add(&world->actors, dc_Actor_create_bat(world->frame_data, pos));
+  }
+  int player = dc_World_player(world);
+  world->actors.position[player] = center;
+}
+
+// everything stacked on the player's tile, so every query comes back with everyone
+static void dc_setup_pile_up(dc_World* world, unsigned int actors) {
+  dc_make_player_immortal(world);
+  int player = dc_World_player(world);
+  Vector2 center = world->actors.position[player];
+  for(unsigned int b = 0; b < actors; b++) {
+    Vector2 pos = {center.x + (b % 7) * 0.5f, center.y + (b / 7 % 7) * 0.5f};
+    dc_Actors_add(&world->actors, dc_Actor_create_bat(world->frame_data, pos));
+  }
+}
+
+// the player waits in an open west doorway with bats all over the floor, so the ones that can't
+// see them have to follow the flow field round the wall
+static void dc_setup_doorway(dc_World* world, unsigned int actors) {
+  dc_make_player_immortal(world);
+  dc_Room* room = dc_World_room(world);
+  room->doors |= DC_DOOR_WEST;
+  room->doors_opened = true;
+  int player = dc_World_player(world);
+  world->actors.position[player] = (Vector2){3.5f * DC_WALL_CELL_WIDTH, 22.5f * DC_WALL_CELL_HEIGHT};
+  for(unsigned int b = 0; b < actors; b++) {
+    Vector2 pos = {TILE_WIDTH * (2.5f + (b % 64) * 0.22f), TILE_HEIGHT * (3.2f + (b / 64 % 64) * 0.035f)};
+    dc_Actors_add(&world->actors, dc_Actor_create_bat(world->frame_data, pos));
+  }
+}
+
+static void dc_setup_nothing(dc_World* world, unsigned int actors) {
+}
+
+static dc_Input dc_input_idle(const dc_World* world, unsigned long step) {
+  return (dc_Input){0};
+}
+
+// a click every step, sweeping the aim around the player
+static dc_Input dc_input_slice_spam(const dc_World* world, unsigned long step) {
+  int player = dc_World_player(world);
+  Vector2 at = player >= 0 ? world->actors.position[player] : (Vector2){0};
+  float angle = step * 0.3f;
+  return (dc_Input){.aim = {at.x + cosf(angle) * 20, at.y + sinf(angle) * 20}, .slice = true};
+}
+
+static const dc_Scenario dc_scenarios[] = {
+  {"homing_bats", 4096, 600, dc_setup_homing, dc_input_idle},
+  {"slice_spam", 256, 1200, dc_setup_homing, dc_input_slice_spam},
+  {"room_walk", 0, 20000, dc_setup_nothing, dc_sim_scripted_input},
+  {"pile_up", 1024, 300, dc_setup_pile_up, dc_input_idle},
+  {"doorway_swarm", 4096, 600, dc_setup_doorway, dc_input_idle}
+};
+#define SCENARIO_COUNT (sizeof(dc_scenarios) / sizeof(dc_scenarios[0]))
+
+static dc_ScenarioResult dc_run_scenario(const dc_Scenario* scenario, dc_Frames* frame_data) {
+  static const float dt = SIM_DT;
+  // every scenario starts from the same dungeon
+  dc_World world;
+  dc_World_init(&world, frame_data, 1);
+  scenario->setup(&world, scenario->actors);
+
+  dc_ScenarioResult result = {0};
+  unsigned long allocs = 0;
+  double elapsed = 0;
+  for(unsigned long step = 0; step < WARMUP_STEPS + scenario->steps; step++) {
+    bool measured = step >= WARMUP_STEPS;
+    dc_Input input = scenario->input(&world, step);
+    unsigned int count = world.actors.count;
+    unsigned long allocs_before = dc_bench_allocs;
+    double start = dc_time_now();
+    dc_sim_step(&world, input, dt);
+    if(measured) {
+      double step_time = dc_time_now() - start;
+      elapsed += step_time;
+      allocs += dc_bench_allocs - allocs_before;
+      result.actor_steps += count;
+      if(world.events & DC_EVENT_ROOM_CHANGED) {
+        result.rooms_entered++;
+        if(step_time * 1000 > result.worst_entry_ms) result.worst_entry_ms = step_time * 1000;
+      }
+    }
+    // same as headless: start over when the run ends so the walk keeps going
+    if(dc_World_player(&world) < 0 || world.rooms_cleared >= ROOMS_TO_WIN) {
+      dc_World_free(&world);
+      dc_World_init(&world, frame_data, 1);
+      scenario->setup(&world, scenario->actors);
+    }
+  }
+  dc_World_free(&world);
+
+  result.ns_per_actor_step = result.actor_steps ? elapsed * 1e9 / result.actor_steps : 0;
+  result.ms_per_step = elapsed * 1000 / scenario->steps;
+  result.allocs_per_step = allocs / (double)scenario->steps;
+  return result;
+}
+
+// pulls one number for a scenario out of a file we wrote ourselves, so no need for a real parser
+static bool dc_baseline_value(const char* json, const char* scenario, const char* key, double* out) {
+  char needle[128];
+  snprintf(needle, sizeof(needle), "\"name\": \"%s\"", scenario);
+  const char* at = strstr(json, needle);
+  if(!at) return false;
+  const char* end = strchr(at, '}');
+  snprintf(needle, sizeof(needle), "\"%s\": ", key);
+  at = strstr(at, needle);
+  if(!at || (end && at > end)) return false;
+  *out = strtod(at + strlen(needle), NULL);
+  return true;
+}
+
+static char* dc_read_file(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if(!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char* data = malloc(size + 1);
+  data[fread(data, 1, size, f)] = '\0';
+  fclose(f);
+  return data;
+}
+
+static void dc_write_results(FILE* out, const dc_ScenarioResult* results, const bool* ran) {
+  fprintf(out, "{\n  \"kernels\": \"%s\",\n  \"threads\": %u,\n  \"scenarios\": [", dc_kernels.name, dc_jobs_worker_count());
+  bool first = true;
+  for(unsigned int s = 0; s < SCENARIO_COUNT; s++) {
+    if(!ran[s]) continue;
+    const dc_ScenarioResult* r = &results[s];
+    fprintf(out, "%s\n    {\"name\": \"%s\", \"steps\": %lu, \"actor_steps\": %lu, \"ns_per_actor_step\": %.3f, \"ms_per_step\": %.4f, \"allocs_per_step\": %.3f, \"rooms_entered\": %lu, \"worst_entry_ms\": %.4f}", first ? "" : ",", dc_scenarios[s].name, dc_scenarios[s].steps, r->actor_steps, r->ns_per_actor_step, r->ms_per_step, r->allocs_per_step, r->rooms_entered, r->worst_entry_ms);
+    first = false;
+  }
+  fprintf(out, "\n  ]\n}\n");
+}
+
+// timing has to get threshold percent worse to count, allocations can't go up at all. a baseline
+// that isn't there, or doesn't have a scenario in it, can't vouch for anything so it fails too
+static int dc_compare_baseline(const char* path, const dc_ScenarioResult* results, const bool* ran, double threshold) {
+  char* json = dc_read_file(path);
+  if(!json) {
+    fprintf(stderr, "can't read a baseline from %s, record one with `make bench-baseline`\n", path);
+    return 1;
+  }
+  int regressions = 0;
+  for(unsigned int s = 0; s < SCENARIO_COUNT; s++) {
+    if(!ran[s]) continue;
+    double ns, allocs;
+    if(!dc_baseline_value(json, dc_scenarios[s].name, "ns_per_actor_step", &ns) || !dc_baseline_value(json, dc_scenarios[s].name, "allocs_per_step", &allocs)) {
+      fprintf(stderr, "%-12s not in the baseline, record a new one with `make bench-baseline`\n", dc_scenarios[s].name);
+      regressions++;
+      continue;
+    }
+    double change = ns > 0 ? (results[s].ns_per_actor_step - ns) / ns * 100 : 0;
+    bool slower = change > threshold;
+    bool allocates_more = results[s].allocs_per_step > allocs + 0.0005;
+    fprintf(stderr, "%-12s %9.2f ns/actor-step (baseline %9.2f, %+6.1f%%) %7.3f allocs/step (baseline %7.3f)%s\n", dc_scenarios[s].name, results[s].ns_per_actor_step, ns, change, results[s].allocs_per_step, allocs, slower || allocates_more ? "  REGRESSION" : "");
+    if(slower || allocates_more) regressions++;
+  }
+  free(json);
+  return regressions;
+}
+
+// scatters n actors at a constant density and times one collision pass over them. up to
+// a few thousand actors it also runs the old all-pairs pass on a copy and checks both agree
+void dc_run_collision_stress(void) {
+  dc_Frames frame_data = dc_Frames_create((dc_Tilesets){0});
+  // slices aren't actors any more, but something with no layer that only hits enemies still
+  // makes for a lopsided mask
+  dc_Actor attacker = dc_Actor_create_bat(&frame_data, (Vector2){0});
+  attacker.collider = (dc_Collider){.layer = 0, .mask = COL_LAYER_ENEMY, .damage = 1};
+  attacker.ai = DC_AI_NONE;
+  dc_Actor templates[] = {dc_Actor_create_bat(&frame_data, (Vector2){0}), dc_Actor_create_player(&frame_data), attacker};
+  dc_Broadphase bp = {0};
+
+  for(unsigned int n = 1024; n <= 65536; n *= 2) {
+    dc_Actors actors, reference;
+    dc_Actors_init(&actors, n);
+    dc_Actors_init(&reference, n);
+    float side = sqrtf(n * 2.f) * TILE_WIDTH; // about one actor every other cell
+    unsigned int seed = 12345;
+    for(unsigned int a = 0; a < n; a++) {
+      dc_Actor actor = templates[a % 8 == 0 ? 1 : a % 8 == 1 ? 2 : 0];
+      seed = seed * 1103515245u + 12345u;
+      actor.position.x = (seed >> 8) % 65536 / 65536.f * side;
+      seed = seed * 1103515245u + 12345u;
+      actor.position.y = (seed >> 8) % 65536 / 65536.f * side;
+      dc_Actors_add(&actors, actor);
+      dc_Actors_add(&reference, actor);
+    }
+
+    double start = dc_time_now();
+    dc_Actors_handle_collisions(&bp, &actors);
+    double elapsed = dc_time_now() - start;
+
+    const char* verdict = "skipped";
+    if(n <= 4096) {
+      dc_Actors_handle_collisions_naive(&reference);
+      verdict = "match";
+      for(unsigned int a = 0; a < n; a++) {
+        if(actors.health[a].hp != reference.health[a].hp || actors.should_be_freed[a] != reference.should_be_freed[a] || actors.iframe_time_remaining[a] != reference.iframe_time_remaining[a] || actors.velocity[a].x != reference.velocity[a].x || actors.velocity[a].y != reference.velocity[a].y) {
+          verdict = "MISMATCH";
+        }
+      }
+    }
+    printf("collision stress: %6u actors %9.3fms %7.1fns/actor (vs all-pairs: %s)\n", n, elapsed * 1000, elapsed * 1e9 / n, verdict);
+
+    dc_Actors_free(&actors);
+    dc_Actors_free(&reference);
+  }
+
+  dc_Broadphase_free(&bp);
+}
+
+// homing + timers + integration over a few thousand bats: the old per-actor atan2/cos/sin path
+// against every kernel set this cpu can run
+void dc_run_kernel_bench(void) {
+  static const unsigned int n = 4096;
+  static const unsigned int steps = 2000;
+  static const float dt = 1.f / 60.f;
+  dc_Frames frame_data = dc_Frames_create((dc_Tilesets){0});
+  Vector2 target = {160, 90};
+
+  dc_Actors actors;
+  dc_Actors_init(&actors, n);
+  const dc_Kernels* available[4];
+  unsigned int kernel_count = dc_kernels_available(available, 4);
+
+  for(int k = -1; k < (int)kernel_count; k++) {
+    actors.count = 0;
+    unsigned int seed = 12345;
+    for(unsigned int a = 0; a < n; a++) {
+      seed = seed * 1103515245u + 12345u;
+      float x = (seed >> 8) % 320;
+      seed = seed * 1103515245u + 12345u;
+      float y = (seed >> 8) % 180;
+      dc_Actor bat = dc_Actor_create_bat(&frame_data, (Vector2){x, y});
+      bat.iframe_time_remaining = a % 5 == 0 ? 0.5f : 0.f;
+      dc_Actors_add(&actors, bat);
+    }
+
+    double start = dc_time_now();
+    for(unsigned int s = 0; s < steps; s++) {
+      if(k < 0) {
+        for(unsigned int a = 0; a < n; a++) {
+          if(actors.ai[a] != DC_AI_BAT || actors.iframe_time_remaining[a] > 0) continue;
+          Vector2 v = dc_get_direction_to(actors.position[a], target);
+          actors.velocity[a] = (Vector2){v.x * 50, v.y * 50};
+        }
+        for(unsigned int a = 0; a < n; a++) {
+          actors.time_until_next_frame[a] -= dt;
+          if(actors.iframe_time_remaining[a] > 0) actors.iframe_time_remaining[a] -= dt;
+          actors.position[a].x += actors.velocity[a].x * dt;
+          actors.position[a].y += actors.velocity[a].y * dt;
+        }
+      } else {
+        available[k]->seek(actors.position, actors.velocity, actors.ai, actors.iframe_time_remaining, n, target, 50);
+        available[k]->tick_timers(actors.time_until_next_frame, actors.iframe_time_remaining, n, dt);
+        available[k]->integrate(actors.position, actors.velocity, n, dt);
+      }
+    }
+    double elapsed = dc_time_now() - start;
+    printf("kernel bench: %-14s %6.2fns/actor-step\n", k < 0 ? "atan2 per actor" : available[k]->name, elapsed * 1e9 / ((double)n * steps));
+  }
+
+  dc_Actors_free(&actors);
+}
+
+// snapshot size and write/read/rewind costs with more and more bats, plus a check that carrying
+// on from a loaded snapshot ends up exactly where carrying on the first time did
+void dc_run_snapshot_bench(void) {
+  static const unsigned int rounds = 1000;
+  static const unsigned long resume_steps = 300;
+  static const float dt = SIM_DT;
+  static const unsigned int swarms[] = {0, 256, 4096};
+  dc_Frames frame_data = dc_Frames_create((dc_Tilesets){0});
+
+  for(unsigned int s = 0; s < sizeof(swarms) / sizeof(swarms[0]); s++) {
+    dc_World world;
+    dc_World_init(&world, &frame_data, 1);
+    dc_setup_homing(&world, swarms[s]);
+    for(unsigned long step = 0; step < WARMUP_STEPS; step++) dc_sim_step(&world, dc_sim_scripted_input(&world, step), dt);
+
+    size_t size = dc_snapshot_size(&world);
+    void* data = malloc(size);
+    double start = dc_time_now();
+    for(unsigned int r = 0; r < rounds; r++) dc_snapshot_write(&world, data);
+    double write_time = (dc_time_now() - start) / rounds;
+    start = dc_time_now();
+    for(unsigned int r = 0; r < rounds; r++) dc_snapshot_read(&world, data, size);
+    double read_time = (dc_time_now() - start) / rounds;
+
+    // a rewind ring's worth of pushes, one per step like the game does. it's filled once first
+    // so the times are for slots that have already been grown and touched
+    dc_Rewind rewind;
+    dc_Rewind_init(&rewind, resume_steps);
+    for(unsigned long step = 0; step < resume_steps; step++) dc_Rewind_push(&rewind, &world);
+    double push_time = 0;
+    for(unsigned long step = 0; step < resume_steps; step++) {
+      dc_sim_step(&world, dc_sim_scripted_input(&world, WARMUP_STEPS + step), dt);
+      start = dc_time_now();
+      dc_Rewind_push(&rewind, &world);
+      push_time += dc_time_now() - start;
+    }
+    unsigned long long first = dc_World_hash(&world);
+
+    dc_snapshot_read(&world, data, size);
+    for(unsigned long step = 0; step < resume_steps; step++) dc_sim_step(&world, dc_sim_scripted_input(&world, WARMUP_STEPS + step), dt);
+    bool resumed = dc_World_hash(&world) == first;
+    start = dc_time_now();
+    bool rewound = dc_Rewind_back(&rewind, &world, resume_steps - 1);
+    double rewind_time = dc_time_now() - start;
+
+    printf("snapshot bench: %5u actors %8zu bytes, write %8.2fus, read %8.2fus, push %8.2fus, rewind %ld steps %8.2fus, resumes %s\n", world.actors.count, size, write_time * 1e6, read_time * 1e6, push_time / resume_steps * 1e6, resume_steps - 1, rewind_time * 1e6, resumed && rewound ? "identically" : "DIFFERENTLY");
+    dc_Rewind_free(&rewind);
+    free(data);
+    dc_World_free(&world);
+  }
+}
+
+int main(int argc, char** argv) {
+  dc_kernels_init();
+  unsigned int threads = 1; // one by default so numbers are comparable across machines
+  const char* only = NULL;
+  const char* out_path = NULL;
+  const char* baseline_path = NULL;
+  double threshold = 10;
+  for(int i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "--collision-stress") == 0) {
+      dc_run_collision_stress();
+      return 0;
+    } else if(strcmp(argv[i], "--kernel-bench") == 0) {
+      dc_run_kernel_bench();
+      return 0;
+    } else if(strcmp(argv[i], "--snapshot-bench") == 0) {
+      dc_run_snapshot_bench();
+      return 0;
+    } else if(strcmp(argv[i], "--kernels") == 0 && i + 1 < argc) {
+      if(!dc_kernels_select(argv[++i])) fprintf(stderr, "kernels '%s' aren't available here, using %s\n", argv[i], dc_kernels.name);
+    }
+    else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = strtoul(argv[++i], NULL, 10);
+    else if(strcmp(argv[i], "--only") == 0 && i + 1 < argc) only = argv[++i];
+    else if(strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_path = argv[++i];
+    else if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline_path = argv[++i];
+    else if(strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = strtod(argv[++i], NULL);
+    else {
+      fprintf(stderr, "unknown argument %s\n", argv[i]);
+      return 2;
+    }
+  }
+  dc_jobs_init(threads);
+
+  dc_Frames frame_data = dc_Frames_create((dc_Tilesets){0});
+  dc_ScenarioResult results[SCENARIO_COUNT] = {0};
+  bool ran[SCENARIO_COUNT] = {0};
+  for(unsigned int s = 0; s < SCENARIO_COUNT; s++) {
+    if(only && strcmp(only, dc_scenarios[s].name) != 0) continue;
+    results[s] = dc_run_scenario(&dc_scenarios[s], &frame_data);
+    for(unsigned int run = 1; run < BENCH_RUNS; run++) {
+      dc_ScenarioResult again = dc_run_scenario(&dc_scenarios[s], &frame_data);
+      if(again.ns_per_actor_step < results[s].ns_per_actor_step) results[s] = again;
+    }
+    ran[s] = true;
+  }
+
+  dc_write_results(stdout, results, ran);
+  if(out_path) {
+    FILE* out = fopen(out_path, "w");
+    if(!out) {
+      fprintf(stderr, "can't write %s\n", out_path);
+      return 1;
+    }
+    dc_write_results(out, results, ran);
+    fclose(out);
+  }
+  int regressions = baseline_path ? dc_compare_baseline(baseline_path, results, ran, threshold) : 0;
+  dc_jobs_shutdown();
+  return regressions ? 1 : 0;
+}
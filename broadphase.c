@@ -0,0 +1,161 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "broadphase.h"
+
+static int dc_cell_coord(float v) {
+  return (int)floorf(v / DC_BROADPHASE_CELL);
+}
+
+static unsigned int dc_cell_hash(int cx, int cy, unsigned int table_size) {
+  return ((unsigned int)cx * 73856093u ^ (unsigned int)cy * 19349663u) & (table_size - 1);
+}
+
+static int dc_uint_cmp(const void* a, const void* b) {
+  unsigned int x = *(const unsigned int*)a;
+  unsigned int y = *(const unsigned int*)b;
+  return (x > y) - (x < y);
+}
+
+void dc_IndexList_push(dc_IndexList* list, unsigned int v) {
+  if(list->count == list->capacity) {
+    list->capacity = list->capacity ? list->capacity * 2 : 64;
+    list->items = realloc(list->items, sizeof(unsigned int) * list->capacity);
+  }
+  list->items[list->count++] = v;
+}
+
+void dc_IndexList_free(dc_IndexList* list) {
+  free(list->items);
+  *list = (dc_IndexList){0};
+}
+
+void dc_Broadphase_free(dc_Broadphase* bp) {
+  free(bp->keys);
+  for(int l = 0; l < DC_COL_LAYERS; l++) {
+    free(bp->cell_start[l]);
+    free(bp->entries[l]);
+  }
+  for(unsigned int w = 0; w < bp->worker_scratch_count; w++) dc_IndexList_free(&bp->worker_scratch[w]);
+  free(bp->worker_scratch);
+  for(unsigned int c = 0; c < bp->chunk_pairs_count; c++) dc_IndexList_free(&bp->chunk_pairs[c]);
+  free(bp->chunk_pairs);
+  *bp = (dc_Broadphase){0};
+}
+
+void dc_Broadphase_reserve_lists(dc_Broadphase* bp, unsigned int workers, unsigned int chunks) {
+  if(workers > bp->worker_scratch_count) {
+    bp->worker_scratch = realloc(bp->worker_scratch, sizeof(dc_IndexList) * workers);
+    for(unsigned int w = bp->worker_scratch_count; w < workers; w++) bp->worker_scratch[w] = (dc_IndexList){0};
+    bp->worker_scratch_count = workers;
+  }
+  if(chunks > bp->chunk_pairs_count) {
+    bp->chunk_pairs = realloc(bp->chunk_pairs, sizeof(dc_IndexList) * chunks);
+    for(unsigned int c = bp->chunk_pairs_count; c < chunks; c++) bp->chunk_pairs[c] = (dc_IndexList){0};
+    bp->chunk_pairs_count = chunks;
+  }
+}
+
+// only grows, so after the first few steps building never hits the allocator
+static void dc_Broadphase_reserve(dc_Broadphase* bp, unsigned int count) {
+  unsigned int table_size = 64;
+  while(table_size < count * 2) table_size *= 2;
+
+  if(count > bp->capacity) {
+    bp->capacity = count;
+    bp->keys = realloc(bp->keys, sizeof(unsigned int) * count);
+    for(int l = 0; l < DC_COL_LAYERS; l++) {
+      bp->entries[l] = realloc(bp->entries[l], sizeof(unsigned int) * count);
+    }
+  }
+  if(table_size > bp->table_size) {
+    bp->table_size = table_size;
+    for(int l = 0; l < DC_COL_LAYERS; l++) {
+      bp->cell_start[l] = realloc(bp->cell_start[l], sizeof(unsigned int) * (table_size + 1));
+    }
+  }
+}
+
+void dc_Broadphase_build(dc_Broadphase* bp, const Vector2* position, const dc_Collider* collider, unsigned int count) {
+  dc_Broadphase_reserve(bp, count);
+
+  for(unsigned int a = 0; a < count; a++) {
+    bp->keys[a] = dc_cell_hash(dc_cell_coord(position[a].x), dc_cell_coord(position[a].y), bp->table_size);
+  }
+
+  // counting sort per layer: count, prefix sum, scatter. scattering in index order keeps each cell ascending
+  for(int l = 0; l < DC_COL_LAYERS; l++) {
+    unsigned int layer = 1u << l;
+    unsigned int* start = bp->cell_start[l];
+    memset(start, 0, sizeof(unsigned int) * (bp->table_size + 1));
+    for(unsigned int a = 0; a < count; a++) {
+      if(collider[a].layer & layer) start[bp->keys[a] + 1]++;
+    }
+    for(unsigned int c = 0; c < bp->table_size; c++) {
+      start[c + 1] += start[c];
+    }
+    for(unsigned int a = 0; a < count; a++) {
+      if(collider[a].layer & layer) bp->entries[l][start[bp->keys[a]]++] = a;
+    }
+    // scattering bumped every start up to the next cell's start, shift them back
+    for(unsigned int c = bp->table_size; c > 0; c--) {
+      start[c] = start[c - 1];
+    }
+    start[0] = 0;
+  }
+}
+
+unsigned int dc_Broadphase_query(const dc_Broadphase* bp, Vector2 pos, unsigned int mask, dc_IndexList* out) {
+  int cx = dc_cell_coord(pos.x);
+  int cy = dc_cell_coord(pos.y);
+  unsigned int n = 0;
+
+  for(int l = 0; l < DC_COL_LAYERS; l++) {
+    if(!(mask & (1u << l))) continue;
+    const unsigned int* start = bp->cell_start[l];
+
+    // neighbouring cells can hash into the same bucket, don't walk a bucket twice
+    unsigned int seen[9];
+    unsigned int seen_count = 0;
+    for(int dy = -1; dy <= 1; dy++) {
+      for(int dx = -1; dx <= 1; dx++) {
+        unsigned int key = dc_cell_hash(cx + dx, cy + dy, bp->table_size);
+        bool dupe = false;
+        for(unsigned int s = 0; s < seen_count; s++) dupe |= seen[s] == key;
+        if(dupe) continue;
+        seen[seen_count++] = key;
+
+        unsigned int len = start[key + 1] - start[key];
+        if(len == 0) continue;
+        if(n + len > out->capacity) {
+          out->capacity = (n + len) * 2;
+          out->items = realloc(out->items, sizeof(unsigned int) * out->capacity);
+        }
+        memcpy(out->items + n, bp->entries[l] + start[key], sizeof(unsigned int) * len);
+        n += len;
+      }
+    }
+  }
+
+  // callers resolve pairs in actor index order so results match a plain nested loop
+  if(n > 1) {
+    if(n <= 32) {
+      for(unsigned int i = 1; i < n; i++) {
+        unsigned int v = out->items[i];
+        unsigned int j = i;
+        for(; j > 0 && out->items[j - 1] > v; j--) out->items[j] = out->items[j - 1];
+        out->items[j] = v;
+      }
+    } else {
+      qsort(out->items, n, sizeof(unsigned int), dc_uint_cmp);
+    }
+    unsigned int unique = 1;
+    for(unsigned int i = 1; i < n; i++) {
+      if(out->items[i] != out->items[unique - 1]) out->items[unique++] = out->items[i];
+    }
+    n = unique;
+  }
+
+  out->count = n;
+  return n;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "actors.h"
+
+// how many collision layer bits get their own grid (COL_LAYER_PLAYER, COL_LAYER_ENEMY)
+#define DC_COL_LAYERS 2
+#define DC_BROADPHASE_CELL TILE_WIDTH // two TILE_WIDTH/2 circles can only touch from a neighbouring cell
+
+// grow-only list of actor indices
+typedef struct {
+  unsigned int* items;
+  unsigned int count;
+  unsigned int capacity;
+} dc_IndexList;
+
+void dc_IndexList_push(dc_IndexList* list, unsigned int v);
+void dc_IndexList_free(dc_IndexList* list);
+
+// spatial hash over actor positions, rebuilt once a step. every layer bit gets its own
+// bucket table so a query for a collision_mask never sees actors it can't interact with
+typedef struct {
+  unsigned int table_size; // power of two
+  unsigned int capacity; // actors the per-actor arrays can hold
+  unsigned int* keys; // hashed cell of each actor, indexed like the actor array
+  unsigned int* cell_start[DC_COL_LAYERS]; // table_size + 1 offsets into entries
+  unsigned int* entries[DC_COL_LAYERS]; // actor indices grouped by cell, ascending within a cell
+  // threaded collision passes keep one query list per worker and one pair list per chunk here
+  dc_IndexList* worker_scratch;
+  unsigned int worker_scratch_count;
+  dc_IndexList* chunk_pairs;
+  unsigned int chunk_pairs_count;
+} dc_Broadphase;
+
+void dc_Broadphase_free(dc_Broadphase* bp);
+void dc_Broadphase_build(dc_Broadphase* bp, const Vector2* position, const dc_Collider* collider, unsigned int count);
+// fills out with the index of every actor in one of the `mask` layers close enough to `pos`
+// to maybe touch it, sorted ascending with no duplicates. only reads bp, so any number of
+// threads can query at once as long as each brings its own list
+unsigned int dc_Broadphase_query(const dc_Broadphase* bp, Vector2 pos, unsigned int mask, dc_IndexList* out);
+// makes sure there are at least `workers` scratch lists and `chunks` pair lists
+void dc_Broadphase_reserve_lists(dc_Broadphase* bp, unsigned int workers, unsigned int chunks);
@@ -0,0 +1,70 @@
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <time.h>
+#include "dc.h"
+#include "atlas.h"
+
+void dc_Rng_seed(dc_Rng* rng, unsigned long long seed) {
+  unsigned long long z = seed + 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z ^= z >> 31;
+  rng->state = z ? z : 1; // xorshift gets stuck on 0
+}
+
+unsigned int dc_Rng_next(dc_Rng* rng) {
+  unsigned long long x = rng->state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  rng->state = x;
+  return (x * 0x2545f4914f6cdd1dull) >> 32;
+}
+
+unsigned int dc_Rng_below(dc_Rng* rng, unsigned int n) {
+  // the modulo bias is way below anything a four-way door pick could notice
+  return dc_Rng_next(rng) % n;
+}
+
+float dc_clampf(float n, float min, float max) {
+  return min > n ? min : max < n ? max : n;
+}
+
+double dc_get_vector_length(Vector2 v) {
+  return v.x * v.x + v.y * v.y;
+}
+
+Vector2 dc_normalize_vector(Vector2 v) {
+  double length = dc_get_vector_length(v);
+  return (Vector2){v.x / length, v.y / length};
+}
+
+Vector2 dc_get_direction_to(Vector2 from, Vector2 to) {
+  float dx = to.x - from.x;
+  float dy = to.y - from.y;
+  float rot = atan2(dy, dx);
+  return (Vector2){cos(rot), sin(rot)};
+}
+
+double dc_time_now(void) {
+  // raylib's GetTime() needs a window, and the sim has to run without one
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+dc_Frames dc_Frames_create(dc_Tilesets tilesets) {
+  return (dc_Frames){
+    .textures = {
+      [DC_FRAMES_SKELETON] = {tilesets.atlas, tilesets.atlas},
+      [DC_FRAMES_SLICE] = {tilesets.atlas, tilesets.atlas, tilesets.atlas},
+      [DC_FRAMES_DWARF] = {tilesets.atlas, tilesets.atlas}
+    },
+    .rects = {
+      [DC_FRAMES_SKELETON] = {DC_ATLAS_SKELETON_0, DC_ATLAS_SKELETON_1},
+      [DC_FRAMES_SLICE] = {DC_ATLAS_SLICE_0, DC_ATLAS_SLICE_1, DC_ATLAS_SLICE_2},
+      [DC_FRAMES_DWARF] = {DC_ATLAS_DWARF_0, DC_ATLAS_DWARF_1}
+    },
+    .counts = {[DC_FRAMES_SKELETON] = 2, [DC_FRAMES_SLICE] = 3, [DC_FRAMES_DWARF] = 2}
+  };
+}
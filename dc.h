@@ -0,0 +1,74 @@
+#pragma once
+#include <raylib.h>
+#include <stdbool.h>
+
+#define SCREEN_WIDTH  320
+#define SCREEN_HEIGHT 180
+#define TILE_WIDTH 16.f
+#define TILE_HEIGHT 24.f
+#define TILE_ORIGIN ((Vector2){TILE_WIDTH / 2.f, TILE_HEIGHT / 2.f})
+#define SIM_HZ 60
+#define SIM_DT (1.f / SIM_HZ) // every sim step is exactly this long, however fast frames come
+#define MAX_FRAME_TIME 0.25f // a hitch longer than this is dropped instead of caught up on
+#define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
+#define MAX_FRAMES 4
+#define INITIAL_ACTORS 128 // actor storage grows past this if it has to
+#define IFRAME_DURATION 1.f
+#define IFRAME_FLASH_SPEED 4.f // N times a second
+#define FLOOR_WIDTH 4096 // rooms are only stored once generated, see floor.h. 65536 at most
+#define FLOOR_HEIGHT 4096 // 65535 at most, the room at y 65535 could have floor.c's empty key
+#define FLOOR_START_X (FLOOR_WIDTH / 2)
+#define FLOOR_START_Y (FLOOR_HEIGHT / 2)
+#define ROOMS_TO_WIN 10
+
+#define COL_LAYER_PLAYER 1 // 0b01
+#define COL_LAYER_ENEMY 2 //  0b10
+
+// every sprite lives in the one atlas, see gfx/atlas.txt for what's in it
+typedef struct {
+  Texture2D atlas;
+} dc_Tilesets;
+
+// sprites say which of these they use by index, so the sim state has no pointers in it
+typedef enum {
+  DC_FRAMES_SKELETON,
+  DC_FRAMES_SLICE,
+  DC_FRAMES_DWARF,
+  DC_FRAMES_COUNT
+} dc_FrameSet;
+
+typedef struct {
+  Texture2D textures[DC_FRAMES_COUNT][MAX_FRAMES];
+  Rectangle rects[DC_FRAMES_COUNT][MAX_FRAMES];
+  unsigned int counts[DC_FRAMES_COUNT];
+} dc_Frames;
+
+#define DC_DOOR_NORTH 1 // 0b0001
+#define DC_DOOR_SOUTH 2 // 0b0010
+#define DC_DOOR_EAST 4  // 0b0100
+#define DC_DOOR_WEST 8  // 0b1000
+
+// one byte a room. a room never gets more than 4 bats
+typedef struct {
+  unsigned char doors : 4; // DC_DOOR_*
+  unsigned char doors_opened : 1;
+  unsigned char remaining_monsters : 3;
+} dc_Room;
+
+// the game's own random numbers, so a seed is all it takes to get the same dungeon back.
+// splitmix64 seeding into xorshift64*
+typedef struct {
+  unsigned long long state;
+} dc_Rng;
+
+void dc_Rng_seed(dc_Rng* rng, unsigned long long seed);
+unsigned int dc_Rng_next(dc_Rng* rng);
+unsigned int dc_Rng_below(dc_Rng* rng, unsigned int n); // 0..n-1
+
+float dc_clampf(float n, float min, float max);
+double dc_get_vector_length(Vector2 v);
+Vector2 dc_normalize_vector(Vector2 v);
+Vector2 dc_get_direction_to(Vector2 from, Vector2 to);
+// frame tables pointing into the atlas. headless passes a zeroed dc_Tilesets, only the counts matter there
+dc_Frames dc_Frames_create(dc_Tilesets tilesets);
+double dc_time_now(void); // monotonic seconds, works without a window
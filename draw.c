@@ -0,0 +1,276 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "draw.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define DC_DRAW_SSE2
+#include <emmintrin.h>
+#endif
+
+#define DC_DRAW_MAX_TEXTURES 16
+#define DC_TEXT_LINE_SPACING 2 // what DrawTextEx moves down by on top of the size for a \n
+
+// gpu
+
+static void dc_gpu_texture(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+  DrawTexturePro(texture, source, dest, origin, rotation, tint);
+}
+
+static void dc_gpu_ellipse(int center_x, int center_y, float radius_h, float radius_v, Color color) {
+  DrawEllipse(center_x, center_y, radius_h, radius_v, color);
+}
+
+static void dc_gpu_text(Font font, const char* text, Vector2 position, float size, float spacing, Color tint) {
+  DrawTextEx(font, text, position, size, spacing, tint);
+}
+
+static void dc_gpu_clear(Color color) {
+  ClearBackground(color);
+}
+
+static void dc_gpu_blend(int mode) {
+  if(mode == BLEND_ALPHA) EndBlendMode();
+  else BeginBlendMode(mode);
+}
+
+static const dc_Draw dc_draw_gpu_backend = {"gpu", dc_gpu_texture, dc_gpu_ellipse, dc_gpu_text, dc_gpu_clear, dc_gpu_blend};
+dc_Draw dc_draw = {"gpu", dc_gpu_texture, dc_gpu_ellipse, dc_gpu_text, dc_gpu_clear, dc_gpu_blend};
+
+void dc_draw_gpu(void) {
+  dc_draw = dc_draw_gpu_backend;
+}
+
+// cpu
+
+static struct {
+  Image* target;
+  int blend;
+  Image* textures[DC_DRAW_MAX_TEXTURES]; // texture id - 1
+  unsigned int texture_count;
+} dc_cpu = {.blend = BLEND_ALPHA};
+
+Texture2D dc_draw_cpu_texture(Image* pixels) {
+  if(dc_cpu.texture_count >= DC_DRAW_MAX_TEXTURES) return (Texture2D){0};
+  dc_cpu.textures[dc_cpu.texture_count++] = pixels;
+  return (Texture2D){.id = dc_cpu.texture_count, .width = pixels->width, .height = pixels->height, .mipmaps = 1, .format = pixels->format};
+}
+
+// one pixel through the blend unit. s is texel * tint for each colour channel and a the same for
+// alpha, all out of 255 * 255. gl works it out in float and rounds once on the way into the
+// target, so this puts everything over one denominator and rounds at the end the same way
+static inline void dc_cpu_blend_pixel(unsigned char* d, const uint64_t s[3], uint64_t a) {
+  static const uint64_t full = 255 * 255;
+  if(dc_cpu.blend == BLEND_ALPHA_PREMULTIPLY) {
+    // ONE, ONE_MINUS_SRC_ALPHA
+    for(int c = 0; c < 3; c++) d[c] = (255 * s[c] + d[c] * (full - a) + full / 2) / full;
+    d[3] = (255 * a + d[3] * (full - a) + full / 2) / full;
+  } else {
+    // SRC_ALPHA, ONE_MINUS_SRC_ALPHA, alpha included
+    static const uint64_t den = full * full;
+    for(int c = 0; c < 3; c++) d[c] = (255 * s[c] * a + d[c] * (full - a) * full + den / 2) / den;
+    d[3] = (255 * a * a + d[3] * (full - a) * full + den / 2) / den;
+  }
+}
+
+static inline void dc_cpu_texel(unsigned char* dst, const unsigned char* texel, Color tint) {
+  uint64_t s[3] = {texel[0] * tint.r, texel[1] * tint.g, texel[2] * tint.b};
+  dc_cpu_blend_pixel(dst, s, texel[3] * tint.a);
+}
+
+static void dc_cpu_pixels(unsigned char* dst, const unsigned char* src, int n, Color tint) {
+  for(int i = 0; i < n; i++) dc_cpu_texel(dst + i * 4, src + i * 4, tint);
+}
+
+// a row of a sprite drawn at 1:1. with an opaque tint every texel that's fully opaque or fully
+// clear has an exact shortcut (tinted copy or nothing), and pixel art is nothing but those
+static void dc_cpu_span(unsigned char* dst, const unsigned char* src, int n, Color tint) {
+  int i = 0;
+#ifdef DC_DRAW_SSE2
+  if(dc_cpu.blend == BLEND_ALPHA && tint.a == 255) {
+    bool white = tint.r == 255 && tint.g == 255 && tint.b == 255;
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tint16 = _mm_setr_epi16(tint.r, tint.g, tint.b, 255, tint.r, tint.g, tint.b, 255);
+    const __m128i half = _mm_set1_epi16(128);
+    for(; i + 4 <= n; i += 4) {
+      __m128i s = _mm_loadu_si128((const __m128i*)(src + i * 4));
+      __m128i a = _mm_and_si128(s, alpha_mask);
+      __m128i opaque = _mm_cmpeq_epi32(a, alpha_mask);
+      __m128i clear = _mm_cmpeq_epi32(a, zero);
+      if(_mm_movemask_epi8(_mm_or_si128(opaque, clear)) != 0xFFFF) {
+        dc_cpu_pixels(dst + i * 4, src + i * 4, 4, tint);
+        continue;
+      }
+      if(_mm_movemask_epi8(clear) == 0xFFFF) continue;
+      if(!white) {
+        // round(texel * tint / 255) in 16 bit lanes, exact for everything up to 255 * 255
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), tint16), half);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), tint16), half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        s = _mm_packus_epi16(lo, hi);
+      }
+      __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+      _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_or_si128(_mm_and_si128(opaque, s), _mm_andnot_si128(opaque, d)));
+    }
+  }
+#endif
+  dc_cpu_pixels(dst + i * 4, src + i * 4, n - i, tint);
+}
+
+static inline int dc_clampi(int v, int lo, int hi) {
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+// pixels whose centre lands in [from, to)
+static inline void dc_cpu_cover(float from, float to, int limit, int* first, int* last) {
+  *first = dc_clampi((int)ceilf(from - 0.5f), 0, limit);
+  *last = dc_clampi((int)ceilf(to - 0.5f), 0, limit);
+}
+
+static void dc_cpu_texture(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+  Image* target = dc_cpu.target;
+  if(!target || texture.id == 0 || texture.id > dc_cpu.texture_count || dest.width <= 0 || dest.height <= 0) return;
+  const Image* src = dc_cpu.textures[texture.id - 1];
+  const unsigned char* texels = src->data;
+  unsigned char* pixels = target->data;
+
+  // texel space edges of the quad, a negative size flips it like DrawTexturePro does
+  float u0 = source.x, u1 = source.x + source.width;
+  float v0 = source.y, v1 = source.y + source.height;
+  if(source.width < 0) u0 = source.x - source.width, u1 = source.x;
+  if(source.height < 0) v0 = source.y - source.height, v1 = source.y;
+  float du = (u1 - u0) / dest.width;
+  float dv = (v1 - v0) / dest.height;
+
+  if(rotation == 0) {
+    float x0 = dest.x - origin.x;
+    float y0 = dest.y - origin.y;
+    int px0, px1, py0, py1;
+    dc_cpu_cover(x0, x0 + dest.width, target->width, &px0, &px1);
+    dc_cpu_cover(y0, y0 + dest.height, target->height, &py0, &py1);
+    // 1:1 and the right way round, so a whole row of texels lines up with a row of pixels
+    bool straight = du == 1.f;
+    for(int py = py0; py < py1; py++) {
+      int ty = dc_clampi((int)floorf(v0 + (py + 0.5f - y0) * dv), 0, src->height - 1);
+      const unsigned char* row = texels + (size_t)ty * src->width * 4;
+      unsigned char* out = pixels + ((size_t)py * target->width + px0) * 4;
+      if(straight) {
+        int tx0 = (int)floorf(u0 + (px0 + 0.5f - x0));
+        int first = px0 + dc_clampi(-tx0, 0, px1 - px0);
+        int last = px0 + dc_clampi(src->width - tx0, 0, px1 - px0);
+        dc_cpu_span(out + (first - px0) * 4, row + (tx0 + first - px0) * 4, last - first, tint);
+        continue;
+      }
+      for(int px = px0; px < px1; px++, out += 4) {
+        int tx = dc_clampi((int)floorf(u0 + (px + 0.5f - x0) * du), 0, src->width - 1);
+        dc_cpu_texel(out, row + tx * 4, tint);
+      }
+    }
+    return;
+  }
+
+  // rotated about dest.x, dest.y. walk the corners' bounding box and map each pixel centre back
+  // into the quad
+  float s = sinf(rotation * DEG2RAD), c = cosf(rotation * DEG2RAD);
+  float min_x = dest.x, max_x = dest.x, min_y = dest.y, max_y = dest.y;
+  for(int corner = 0; corner < 4; corner++) {
+    float lx = (corner & 1 ? dest.width : 0) - origin.x;
+    float ly = (corner & 2 ? dest.height : 0) - origin.y;
+    float x = dest.x + lx * c - ly * s;
+    float y = dest.y + lx * s + ly * c;
+    min_x = fminf(min_x, x), max_x = fmaxf(max_x, x);
+    min_y = fminf(min_y, y), max_y = fmaxf(max_y, y);
+  }
+  int px0, px1, py0, py1;
+  dc_cpu_cover(min_x, max_x + 1, target->width, &px0, &px1);
+  dc_cpu_cover(min_y, max_y + 1, target->height, &py0, &py1);
+  for(int py = py0; py < py1; py++) {
+    for(int px = px0; px < px1; px++) {
+      float x = px + 0.5f - dest.x, y = py + 0.5f - dest.y;
+      float lx = x * c + y * s + origin.x;
+      float ly = -x * s + y * c + origin.y;
+      if(lx < 0 || lx >= dest.width || ly < 0 || ly >= dest.height) continue;
+      int tx = dc_clampi((int)floorf(u0 + lx * du), 0, src->width - 1);
+      int ty = dc_clampi((int)floorf(v0 + ly * dv), 0, src->height - 1);
+      dc_cpu_texel(pixels + ((size_t)py * target->width + px) * 4, texels + ((size_t)ty * src->width + tx) * 4, tint);
+    }
+  }
+}
+
+// DrawEllipse's fan of 36 triangles is one convex polygon, so a pixel's in if its centre is
+// inside every edge. centres right on an edge go to top and left edges, same as the gpu
+static void dc_cpu_ellipse(int center_x, int center_y, float radius_h, float radius_v, Color color) {
+  Image* target = dc_cpu.target;
+  if(!target) return;
+  Vector2 points[36];
+  for(int i = 0; i < 36; i++) {
+    points[i] = (Vector2){center_x + cosf(DEG2RAD * i * 10) * radius_h, center_y + sinf(DEG2RAD * i * 10) * radius_v};
+  }
+  int px0, px1, py0, py1;
+  dc_cpu_cover(center_x - radius_h, center_x + radius_h + 1, target->width, &px0, &px1);
+  dc_cpu_cover(center_y - radius_v, center_y + radius_v + 1, target->height, &py0, &py1);
+  uint64_t s[3] = {color.r * 255, color.g * 255, color.b * 255};
+  for(int py = py0; py < py1; py++) {
+    for(int px = px0; px < px1; px++) {
+      float x = px + 0.5f, y = py + 0.5f;
+      bool inside = true;
+      for(int e = 0; e < 36 && inside; e++) {
+        Vector2 a = points[e], b = points[(e + 1) % 36];
+        float w = (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+        inside = w > 0 || (w == 0 && (b.y - a.y < 0 || (b.y == a.y && b.x > a.x)));
+      }
+      if(inside) dc_cpu_blend_pixel((unsigned char*)target->data + ((size_t)py * target->width + px) * 4, s, color.a * 255);
+    }
+  }
+}
+
+static int dc_glyph_index(Font font, int codepoint) {
+  int fallback = 0;
+  for(int g = 0; g < font.glyphCount; g++) {
+    if(font.glyphs[g].value == codepoint) return g;
+    if(font.glyphs[g].value == '?') fallback = g;
+  }
+  return fallback;
+}
+
+// DrawTextEx and DrawTextCodepoint, glyph for glyph. ascii only, which is all we print
+static void dc_cpu_text(Font font, const char* text, Vector2 position, float size, float spacing, Color tint) {
+  if(font.glyphCount == 0) return; // dc --cpu-render --no-text
+  float scale = size / font.baseSize;
+  float pad = font.glyphPadding;
+  float x = 0, y = 0;
+  for(const char* t = text; *t; t++) {
+    if(*t == '\n') {
+      y += size + DC_TEXT_LINE_SPACING;
+      x = 0;
+      continue;
+    }
+    int g = dc_glyph_index(font, (unsigned char)*t);
+    Rectangle rec = font.recs[g];
+    if(*t != ' ' && *t != '\t') {
+      Rectangle source = {rec.x - pad, rec.y - pad, rec.width + 2 * pad, rec.height + 2 * pad};
+      Rectangle dest = {position.x + x + font.glyphs[g].offsetX * scale - pad * scale, position.y + y + font.glyphs[g].offsetY * scale - pad * scale, (rec.width + 2 * pad) * scale, (rec.height + 2 * pad) * scale};
+      dc_cpu_texture(font.texture, source, dest, (Vector2){0}, 0, tint);
+    }
+    x += (font.glyphs[g].advanceX == 0 ? rec.width * scale : font.glyphs[g].advanceX * scale) + spacing;
+  }
+}
+
+static void dc_cpu_clear(Color color) {
+  Image* target = dc_cpu.target;
+  if(!target) return;
+  unsigned char* pixels = target->data;
+  for(size_t p = 0; p < (size_t)target->width * target->height; p++) memcpy(pixels + p * 4, &color, 4);
+}
+
+static void dc_cpu_blend(int mode) {
+  dc_cpu.blend = mode;
+}
+
+void dc_draw_cpu(Image* target) {
+  dc_cpu.target = target;
+  dc_cpu.blend = BLEND_ALPHA;
+  dc_draw = (dc_Draw){"cpu", dc_cpu_texture, dc_cpu_ellipse, dc_cpu_text, dc_cpu_clear, dc_cpu_blend};
+}
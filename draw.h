@@ -0,0 +1,28 @@
+#pragma once
+#include <raylib.h>
+
+// everything the game draws goes through dc_draw. it starts out as plain raylib on the gpu,
+// dc_draw_cpu() points it at an Image instead, which needs no window or gl context at all. the
+// cpu side copies what the gpu does (nearest sampling, pixel centres, the same blend equations
+// and unorm rounding) so for the sprites, shadows and text we draw the two come out the same
+typedef struct {
+  const char* name;
+  // DrawTexturePro
+  void (*texture)(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+  // DrawEllipse, with the shapes texture pointed at something white
+  void (*ellipse)(int center_x, int center_y, float radius_h, float radius_v, Color color);
+  // DrawTextEx
+  void (*text)(Font font, const char* text, Vector2 position, float size, float spacing, Color tint);
+  void (*clear)(Color color);
+  // BLEND_ALPHA or BLEND_ALPHA_PREMULTIPLY, the only two we use
+  void (*blend)(int mode);
+} dc_Draw;
+
+extern dc_Draw dc_draw;
+
+void dc_draw_gpu(void);
+// draws into target (R8G8B8A8) from now on, switching targets is like BeginTextureMode
+void dc_draw_cpu(Image* target);
+// a stand-in texture for the cpu to draw from. pixels has to be R8G8B8A8 and stay put; a
+// canvas can be drawn into and then drawn from, same as a render texture
+Texture2D dc_draw_cpu_texture(Image* pixels);
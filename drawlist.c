@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <math.h>
+#include "drawlist.h"
+
+// depth is y in quarter pixels, offset so anything that survived culling is positive
+#define DC_DEPTH_STEPS_PER_PIXEL 4
+#define DC_DEPTH_OFFSET 256
+
+void dc_DrawList_free(dc_DrawList* list) {
+  free(list->keys);
+  free(list->actors);
+  free(list->positions);
+  free(list->scratch_keys);
+  free(list->scratch_actors);
+  free(list->scratch_positions);
+  *list = (dc_DrawList){0};
+}
+
+void dc_DrawList_clear(dc_DrawList* list) {
+  list->count = 0;
+  list->culled = 0;
+}
+
+static bool dc_overlaps_screen(float min_x, float min_y, float max_x, float max_y) {
+  return max_x >= 0 && min_x <= SCREEN_WIDTH && max_y >= 0 && min_y <= SCREEN_HEIGHT;
+}
+
+void dc_DrawList_add(dc_DrawList* list, const dc_Actors* actors, unsigned int a, Vector2 position) {
+  const dc_Sprite* sprite = &actors->sprite[a];
+  // the sprite turns about its origin, so nothing of it gets further away than the furthest corner
+  float reach_x = fmaxf(fabsf(sprite->origin.x), fabsf(TILE_WIDTH - sprite->origin.x));
+  float reach_y = fmaxf(fabsf(sprite->origin.y), fabsf(TILE_HEIGHT - sprite->origin.y));
+  float reach = sqrtf(reach_x * reach_x + reach_y * reach_y);
+  bool visible = dc_overlaps_screen(position.x - reach, position.y - reach, position.x + reach, position.y + reach);
+  if(!visible && sprite->has_shadow) {
+    Vector2 shadow = {position.x + sprite->shadow_offset.x, position.y + sprite->shadow_offset.y};
+    visible = dc_overlaps_screen(shadow.x - TILE_WIDTH / 2.f, shadow.y - 2, shadow.x + TILE_WIDTH / 2.f, shadow.y + 2);
+  }
+  if(!visible) {
+    list->culled++;
+    return;
+  }
+
+  if(list->count == list->capacity) {
+    list->capacity = list->capacity ? list->capacity * 2 : 256;
+    list->keys = realloc(list->keys, sizeof(uint32_t) * list->capacity);
+    list->actors = realloc(list->actors, sizeof(uint32_t) * list->capacity);
+    list->positions = realloc(list->positions, sizeof(Vector2) * list->capacity);
+    list->scratch_keys = realloc(list->scratch_keys, sizeof(uint32_t) * list->capacity);
+    list->scratch_actors = realloc(list->scratch_actors, sizeof(uint32_t) * list->capacity);
+    list->scratch_positions = realloc(list->scratch_positions, sizeof(Vector2) * list->capacity);
+  }
+  float depth = (position.y + DC_DEPTH_OFFSET) * DC_DEPTH_STEPS_PER_PIXEL;
+  uint32_t quantised = depth <= 0 ? 0 : depth >= 0xFFFF ? 0xFFFF : (uint32_t)depth;
+  list->keys[list->count] = quantised << 8 | (sprite->frames & 0xFF);
+  list->actors[list->count] = a;
+  list->positions[list->count] = position;
+  list->count++;
+}
+
+// lsd radix sort a byte at a time over the 24 bits of key. a pass where every key has the same
+// byte wouldn't move anything, so it's skipped, which is most of them for the frame set byte
+void dc_DrawList_sort(dc_DrawList* list) {
+  for(unsigned int shift = 0; shift < 24; shift += 8) {
+    unsigned int counts[256] = {0};
+    for(unsigned int i = 0; i < list->count; i++) counts[list->keys[i] >> shift & 0xFF]++;
+    if(list->count == 0 || counts[list->keys[0] >> shift & 0xFF] == list->count) continue;
+
+    unsigned int offsets[256];
+    unsigned int total = 0;
+    for(unsigned int b = 0; b < 256; b++) {
+      offsets[b] = total;
+      total += counts[b];
+    }
+    for(unsigned int i = 0; i < list->count; i++) {
+      unsigned int to = offsets[list->keys[i] >> shift & 0xFF]++;
+      list->scratch_keys[to] = list->keys[i];
+      list->scratch_actors[to] = list->actors[i];
+      list->scratch_positions[to] = list->positions[i];
+    }
+
+    uint32_t* keys = list->keys;
+    list->keys = list->scratch_keys;
+    list->scratch_keys = keys;
+    uint32_t* actors = list->actors;
+    list->actors = list->scratch_actors;
+    list->scratch_actors = actors;
+    Vector2* positions = list->positions;
+    list->positions = list->scratch_positions;
+    list->scratch_positions = positions;
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include "actors.h"
+
+// the actors one frame actually draws: whatever overlaps the screen, back to front by y, with
+// sprites from the same texture next to each other. rebuilt every frame into arrays that only
+// ever grow, so it stops allocating once it's seen the biggest crowd
+typedef struct {
+  uint32_t* keys; // depth << 8 | frame set
+  uint32_t* actors; // index into dc_Actors
+  Vector2* positions; // where to draw it, already interpolated
+  uint32_t* scratch_keys;
+  uint32_t* scratch_actors;
+  Vector2* scratch_positions;
+  unsigned int count;
+  unsigned int capacity;
+  unsigned int culled; // how many got left out this frame
+} dc_DrawList;
+
+void dc_DrawList_free(dc_DrawList* list);
+void dc_DrawList_clear(dc_DrawList* list);
+// skips a if neither its sprite nor its shadow would land on the screen
+void dc_DrawList_add(dc_DrawList* list, const dc_Actors* actors, unsigned int a, Vector2 position);
+// stable, so actors with the same key keep the order they were added in
+void dc_DrawList_sort(dc_DrawList* list);
@@ -0,0 +1,46 @@
+#include "effects.h"
+
+const dc_EffectInfo dc_effect_info[DC_EFFECT_KIND_COUNT] = {
+  [DC_EFFECT_SLICE] = {DC_FRAMES_SLICE, 0.1f, {TILE_WIDTH / 2, TILE_HEIGHT / 2}, 1, COL_LAYER_ENEMY}
+};
+
+void dc_Effects_add(dc_Effects* effects, dc_EffectKind kind, Vector2 position, float rotation) {
+  if(effects->count == DC_EFFECTS_CAPACITY) {
+    effects->head = (effects->head + 1) % DC_EFFECTS_CAPACITY;
+    effects->count--;
+    effects->dropped++;
+  }
+  *dc_Effects_at(effects, effects->count++) = (dc_Effect){
+    .position = position,
+    .rotation = rotation,
+    .time_until_next_frame = dc_effect_info[kind].time_per_frame,
+    .kind = kind
+  };
+}
+
+void dc_Effects_update(dc_Effects* effects, const dc_Frames* frame_data, float dt) {
+  for(unsigned int i = 0; i < effects->count; i++) {
+    dc_Effect* e = dc_Effects_at(effects, i);
+    const dc_EffectInfo* info = &dc_effect_info[e->kind];
+    e->time_until_next_frame -= dt;
+    if(e->time_until_next_frame > 0) continue;
+    if(e->frame + 1u >= frame_data->counts[info->frames]) {
+      e->frame = 0;
+      e->done = true;
+    } else {
+      e->frame++;
+    }
+    e->time_until_next_frame += info->time_per_frame;
+  }
+}
+
+void dc_Effects_remove_done(dc_Effects* effects) {
+  unsigned int kept = 0;
+  for(unsigned int i = 0; i < effects->count; i++) {
+    dc_Effect* e = dc_Effects_at(effects, i);
+    if(e->done) continue;
+    if(kept != i) *dc_Effects_at(effects, kept) = *e;
+    kept++;
+  }
+  effects->count = kept;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include "dc.h"
+
+#define DC_EFFECTS_CAPACITY 512 // past this the oldest one gets dropped to make room
+
+typedef enum {
+  DC_EFFECT_SLICE,
+  DC_EFFECT_KIND_COUNT
+} dc_EffectKind;
+
+// what every effect of a kind has in common
+typedef struct {
+  dc_FrameSet frames;
+  float time_per_frame;
+  Vector2 origin;
+  int damage; // 0 for ones that are only for show
+  unsigned int mask; // collision layers it hits
+} dc_EffectInfo;
+
+extern const dc_EffectInfo dc_effect_info[DC_EFFECT_KIND_COUNT];
+
+// something short lived and fire and forget: slashes, sparks. no handle, health, ai or shadow,
+// just enough to play its frames once and, if it hurts, to hit things with while it does
+typedef struct {
+  Vector2 position;
+  float rotation;
+  float time_until_next_frame;
+  uint8_t kind; // dc_EffectKind
+  uint8_t frame;
+  bool done; // played its last frame, it still hits this step and goes in dc_Effects_remove_done
+} dc_Effect;
+
+// a ring over a fixed array, oldest first from head. effects all last about as long, so they
+// finish roughly in the order they started
+typedef struct {
+  dc_Effect items[DC_EFFECTS_CAPACITY];
+  unsigned int head;
+  unsigned int count;
+  unsigned long dropped; // added while it was full
+} dc_Effects;
+
+static inline dc_Effect* dc_Effects_at(dc_Effects* effects, unsigned int i) {
+  return &effects->items[(effects->head + i) % DC_EFFECTS_CAPACITY];
+}
+
+static inline const dc_Effect* dc_Effects_at_const(const dc_Effects* effects, unsigned int i) {
+  return &effects->items[(effects->head + i) % DC_EFFECTS_CAPACITY];
+}
+
+void dc_Effects_add(dc_Effects* effects, dc_EffectKind kind, Vector2 position, float rotation);
+// steps every animation along, marking the ones that just played their last frame
+void dc_Effects_update(dc_Effects* effects, const dc_Frames* frame_data, float dt);
+// drops everything marked done, the rest keep their order
+void dc_Effects_remove_done(dc_Effects* effects);
@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include "floor.h"
+
+#define DC_FLOOR_EMPTY 0xFFFFFFFFu
+
+#if FLOOR_WIDTH > 65536 || FLOOR_HEIGHT > 65535
+#error "floor keys need x < 65536 and y < 65535, y == 65535 would let (65535, 65535) hit DC_FLOOR_EMPTY"
+#endif
+
+static uint32_t dc_floor_key(unsigned int x, unsigned int y) {
+  return (uint32_t)x | (uint32_t)y << 16;
+}
+
+// murmur3's finalizer, neighbouring coordinates end up nowhere near each other
+static unsigned int dc_floor_slot(uint32_t key, unsigned int capacity) {
+  key ^= key >> 16;
+  key *= 0x85ebca6bu;
+  key ^= key >> 13;
+  key *= 0xc2b2ae35u;
+  key ^= key >> 16;
+  return key & (capacity - 1);
+}
+
+static uint32_t* dc_floor_keys_create(unsigned int capacity) {
+  uint32_t* keys = malloc(sizeof(uint32_t) * capacity);
+  for(unsigned int i = 0; i < capacity; i++) keys[i] = DC_FLOOR_EMPTY;
+  return keys;
+}
+
+static unsigned int dc_floor_probe(const uint32_t* keys, unsigned int capacity, uint32_t key) {
+  unsigned int i = dc_floor_slot(key, capacity);
+  while(keys[i] != DC_FLOOR_EMPTY && keys[i] != key) i = (i + 1) & (capacity - 1);
+  return i;
+}
+
+void dc_Floor_init(dc_Floor* floor, unsigned int capacity) {
+  unsigned int c = 16;
+  while(c < capacity) c *= 2;
+  floor->capacity = c;
+  floor->count = 0;
+  floor->keys = dc_floor_keys_create(c);
+  floor->rooms = malloc(sizeof(dc_Room) * c);
+  floor->cleared_count = 0;
+}
+
+void dc_Floor_free(dc_Floor* floor) {
+  free(floor->keys);
+  free(floor->rooms);
+  *floor = (dc_Floor){0};
+}
+
+dc_Room* dc_Floor_find(const dc_Floor* floor, unsigned int x, unsigned int y) {
+  uint32_t key = dc_floor_key(x, y);
+  for(unsigned int i = dc_floor_slot(key, floor->capacity);; i = (i + 1) & (floor->capacity - 1)) {
+    if(floor->keys[i] == key) return &floor->rooms[i];
+    if(floor->keys[i] == DC_FLOOR_EMPTY) return NULL;
+  }
+}
+
+static void dc_Floor_grow(dc_Floor* floor) {
+  unsigned int capacity = floor->capacity * 2;
+  uint32_t* keys = dc_floor_keys_create(capacity);
+  dc_Room* rooms = malloc(sizeof(dc_Room) * capacity);
+  for(unsigned int i = 0; i < floor->capacity; i++) {
+    if(floor->keys[i] == DC_FLOOR_EMPTY) continue;
+    unsigned int s = dc_floor_probe(keys, capacity, floor->keys[i]);
+    keys[s] = floor->keys[i];
+    rooms[s] = floor->rooms[i];
+  }
+  free(floor->keys);
+  free(floor->rooms);
+  floor->keys = keys;
+  floor->rooms = rooms;
+  floor->capacity = capacity;
+}
+
+dc_Room* dc_Floor_insert(dc_Floor* floor, unsigned int x, unsigned int y, dc_Room room) {
+  // kept under 3/4 full so probes stay short and there's always an empty slot to stop on
+  if((floor->count + 1) * 4 > floor->capacity * 3) dc_Floor_grow(floor);
+  uint32_t key = dc_floor_key(x, y);
+  unsigned int i = dc_floor_probe(floor->keys, floor->capacity, key);
+  if(floor->keys[i] == DC_FLOOR_EMPTY) floor->count++;
+  floor->keys[i] = key;
+  floor->rooms[i] = room;
+  return &floor->rooms[i];
+}
+
+void dc_Floor_mark_cleared(dc_Floor* floor, unsigned int x, unsigned int y) {
+  if(floor->cleared_count == DC_FLOOR_CLEARED_MAX || dc_Floor_was_cleared(floor, x, y)) return;
+  floor->cleared[floor->cleared_count++] = dc_floor_key(x, y);
+}
+
+bool dc_Floor_was_cleared(const dc_Floor* floor, unsigned int x, unsigned int y) {
+  uint32_t key = dc_floor_key(x, y);
+  for(unsigned int i = 0; i < floor->cleared_count; i++) {
+    if(floor->cleared[i] == key) return true;
+  }
+  return false;
+}
+
+// backward shift delete: pulls later entries of the probe run back into the hole so lookups
+// never need tombstones
+static void dc_Floor_remove_slot(dc_Floor* floor, unsigned int hole) {
+  unsigned int mask = floor->capacity - 1;
+  for(unsigned int j = (hole + 1) & mask; floor->keys[j] != DC_FLOOR_EMPTY; j = (j + 1) & mask) {
+    unsigned int home = dc_floor_slot(floor->keys[j], floor->capacity);
+    // leave it alone if its home is in (hole, j], moving it would put it before its home
+    if(((j - home) & mask) < ((j - hole) & mask)) continue;
+    floor->keys[hole] = floor->keys[j];
+    floor->rooms[hole] = floor->rooms[j];
+    hole = j;
+  }
+  floor->keys[hole] = DC_FLOOR_EMPTY;
+  floor->count--;
+}
+
+unsigned int dc_Floor_evict_far(dc_Floor* floor, unsigned int x, unsigned int y, unsigned int radius) {
+  unsigned int evicted = 0;
+  for(unsigned int i = 0; i < floor->capacity;) {
+    uint32_t key = floor->keys[i];
+    if(key != DC_FLOOR_EMPTY) {
+      int dx = (int)(key & 0xFFFF) - (int)x;
+      int dy = (int)(key >> 16) - (int)y;
+      if(abs(dx) > (int)radius || abs(dy) > (int)radius) {
+        // whatever gets shifted into i still needs looking at, so don't move on yet
+        dc_Floor_remove_slot(floor, i);
+        evicted++;
+        continue;
+      }
+    }
+    i++;
+  }
+  return evicted;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include "dc.h"
+
+#define DC_FLOOR_KEEP_RADIUS 4 // rooms further than this from the player get evicted
+#define DC_FLOOR_CLEARED_MAX ROOMS_TO_WIN
+
+// the rooms that have been generated so far, keyed by coordinate. open addressing with linear
+// probing, the keys and the packed rooms in separate arrays so a probe only walks the keys.
+// dc_Room_generate can always make an evicted room again, all it can't know is that the room got
+// cleared. those keys go in a short list that's never evicted from. it can't outgrow
+// DC_FLOOR_CLEARED_MAX, clearing that many rooms wins and the run's over
+typedef struct {
+  uint32_t* keys; // x | y << 16, DC_FLOOR_EMPTY for an unused slot
+  dc_Room* rooms;
+  unsigned int count;
+  unsigned int capacity; // power of two
+  uint32_t cleared[DC_FLOOR_CLEARED_MAX]; // same keys, in the order the rooms got cleared
+  unsigned int cleared_count;
+} dc_Floor;
+
+void dc_Floor_init(dc_Floor* floor, unsigned int capacity);
+void dc_Floor_free(dc_Floor* floor);
+// NULL if the room hasn't been generated (or got evicted). the pointer is only good until the
+// next insert or evict
+dc_Room* dc_Floor_find(const dc_Floor* floor, unsigned int x, unsigned int y);
+dc_Room* dc_Floor_insert(dc_Floor* floor, unsigned int x, unsigned int y, dc_Room room);
+// remembers that (x, y) was cleared, for whenever it gets generated again. anything past
+// DC_FLOOR_CLEARED_MAX is dropped, every room made after the win comes out empty anyway
+void dc_Floor_mark_cleared(dc_Floor* floor, unsigned int x, unsigned int y);
+bool dc_Floor_was_cleared(const dc_Floor* floor, unsigned int x, unsigned int y);
+// drops every room more than `radius` rooms away from (x, y) in either direction, returns how many
+unsigned int dc_Floor_evict_far(dc_Floor* floor, unsigned int x, unsigned int y, unsigned int radius);
@@ -0,0 +1,81 @@
+#include <math.h>
+#include "flow.h"
+
+static Vector2 dc_flow_cell_center(int col, int row) {
+  return (Vector2){(col + 0.5f) * DC_WALL_CELL_WIDTH, (row + 0.5f) * DC_WALL_CELL_HEIGHT};
+}
+
+// walks the segment in half cell steps, so it can't skip over a cell it crosses
+static bool dc_flow_line_clear(const dc_RoomGrid* grid, Vector2 from, Vector2 to) {
+  float steps = fmaxf(fabsf(to.x - from.x) / DC_WALL_CELL_WIDTH, fabsf(to.y - from.y) / DC_WALL_CELL_HEIGHT) * 2;
+  int n = (int)ceilf(steps);
+  for(int i = 1; i < n; i++) {
+    float t = (float)i / n;
+    if(!dc_RoomGrid_at(grid, (Vector2){from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t})) return false;
+  }
+  return true;
+}
+
+bool dc_FlowField_update(dc_FlowField* flow, const dc_RoomGrid* grid, Vector2 target) {
+  int target_col, target_row;
+  if(!dc_RoomGrid_cell(target, &target_col, &target_row)) return false;
+  if(flow->valid && flow->grid == grid && flow->target_col == target_col && flow->target_row == target_row) return false;
+  flow->valid = true;
+  flow->grid = grid;
+  flow->target_col = target_col;
+  flow->target_row = target_row;
+
+  // breadth first out from the target. the player can stand in doorways that bats can't, so
+  // distances go through every cell that isn't wall and the wall pass keeps bats on the floor
+  for(int r = 0; r < DC_WALL_ROWS; r++) {
+    for(int c = 0; c < DC_WALL_COLS; c++) flow->distance[r][c] = DC_FLOW_UNREACHED;
+  }
+  static const int neighbours[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+  unsigned short queue[DC_WALL_ROWS * DC_WALL_COLS];
+  unsigned int head = 0, tail = 0;
+  flow->distance[target_row][target_col] = 0;
+  queue[tail++] = target_row * DC_WALL_COLS + target_col;
+  while(head < tail) {
+    int r = queue[head] / DC_WALL_COLS;
+    int c = queue[head] % DC_WALL_COLS;
+    head++;
+    for(int n = 0; n < 4; n++) {
+      int nc = c + neighbours[n][0];
+      int nr = r + neighbours[n][1];
+      if(nc < 0 || nc >= DC_WALL_COLS || nr < 0 || nr >= DC_WALL_ROWS) continue;
+      if(!grid->cells[nr][nc] || flow->distance[nr][nc] != DC_FLOW_UNREACHED) continue;
+      flow->distance[nr][nc] = flow->distance[r][c] + 1;
+      queue[tail++] = nr * DC_WALL_COLS + nc;
+    }
+  }
+
+  // each cell points at its closest neighbour. diagonals only when both cells beside it are
+  // open too, so nothing tries to cut through the corner of a wall
+  Vector2 goal = dc_flow_cell_center(target_col, target_row);
+  for(int r = 0; r < DC_WALL_ROWS; r++) {
+    for(int c = 0; c < DC_WALL_COLS; c++) {
+      flow->direction[r][c] = (Vector2){0};
+      flow->direct[r][c] = false;
+      unsigned short best = flow->distance[r][c];
+      if(best == DC_FLOW_UNREACHED || best == 0) continue;
+      int best_n = -1;
+      for(int n = 0; n < 8; n++) {
+        int nc = c + neighbours[n][0];
+        int nr = r + neighbours[n][1];
+        if(nc < 0 || nc >= DC_WALL_COLS || nr < 0 || nr >= DC_WALL_ROWS) continue;
+        if(n >= 4 && (!grid->cells[r][nc] || !grid->cells[nr][c])) continue;
+        if(flow->distance[nr][nc] < best) {
+          best = flow->distance[nr][nc];
+          best_n = n;
+        }
+      }
+      Vector2 from = dc_flow_cell_center(c, r);
+      Vector2 to = dc_flow_cell_center(c + neighbours[best_n][0], r + neighbours[best_n][1]);
+      float dx = to.x - from.x, dy = to.y - from.y;
+      float length = sqrtf(dx * dx + dy * dy);
+      flow->direction[r][c] = (Vector2){dx / length, dy / length};
+      if(grid->cells[r][c] & DC_CELL_FLOOR) flow->direct[r][c] = dc_flow_line_clear(grid, from, goal);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "walls.h"
+
+#define DC_FLOW_UNREACHED 0xFFFF
+
+// how far every cell of a room grid is from the player's cell, and which way to head from each
+// one to get closer. it only gets rebuilt when the player moves to another cell or room, after
+// that steering any number of bats is a lookup each
+typedef struct {
+  bool valid;
+  const dc_RoomGrid* grid; // what it was built over
+  int target_col;
+  int target_row;
+  unsigned short distance[DC_WALL_ROWS][DC_WALL_COLS]; // in steps, through anything that isn't wall
+  Vector2 direction[DC_WALL_ROWS][DC_WALL_COLS]; // unit vector toward the next cell, zero at the target
+  // floor cells the target can be seen from in a straight line. a bat in one of those can just
+  // head straight for the player, which is smoother than following cells
+  bool direct[DC_WALL_ROWS][DC_WALL_COLS];
+} dc_FlowField;
+
+// rebuilds the field toward target unless it's already built toward that cell of that grid.
+// returns whether it did
+bool dc_FlowField_update(dc_FlowField* flow, const dc_RoomGrid* grid, Vector2 target);
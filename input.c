@@ -0,0 +1,91 @@
+#include <string.h>
+#include "input.h"
+
+void dc_InputQueue_init(dc_InputQueue* queue, Vector2 aim) {
+  memset(queue, 0, sizeof(*queue));
+  queue->aim = aim;
+  queue->sampled_aim = aim;
+}
+
+static void dc_InputQueue_apply(dc_InputQueue* queue, dc_InputEvent event, dc_InputStep* step) {
+  uint32_t bit = 1u << event.control;
+  switch(event.kind) {
+  case DC_INPUT_DOWN:
+    if(step->first_press == 0) step->first_press = event.time;
+    queue->held |= bit;
+    step->pressed |= bit;
+    break;
+  case DC_INPUT_UP:
+    queue->held &= ~bit;
+    break;
+  case DC_INPUT_AIM:
+    queue->aim = event.aim;
+    break;
+  }
+}
+
+static void dc_InputQueue_push(dc_InputQueue* queue, dc_InputEvent event) {
+  // only the newest aim in a step matters, so a run of them collapses into one
+  if(event.kind == DC_INPUT_AIM && queue->count > 0 && queue->events[queue->count - 1].kind == DC_INPUT_AIM) {
+    queue->events[queue->count - 1] = event;
+    return;
+  }
+  // full up, which takes a long run of frames without a step. the oldest goes in a step early
+  // rather than getting lost, dropping an up would leave a key stuck
+  if(queue->count == DC_INPUT_QUEUE_SIZE) {
+    dc_InputStep early = {0};
+    dc_InputQueue_apply(queue, queue->events[0], &early);
+    queue->folded_pressed |= early.pressed;
+    queue->count--;
+    memmove(queue->events, queue->events + 1, queue->count * sizeof(dc_InputEvent));
+    queue->folded++;
+  }
+  queue->events[queue->count++] = event;
+}
+
+void dc_InputQueue_sample(dc_InputQueue* queue, double time, uint32_t down, Vector2 aim) {
+  uint32_t changed = down ^ queue->sampled;
+  for(unsigned int control = 0; changed; control++, changed >>= 1) {
+    if(!(changed & 1)) continue;
+    bool is_down = down & (1u << control);
+    dc_InputQueue_push(queue, (dc_InputEvent){.time = time, .kind = is_down ? DC_INPUT_DOWN : DC_INPUT_UP, .control = control});
+  }
+  if(aim.x != queue->sampled_aim.x || aim.y != queue->sampled_aim.y) {
+    dc_InputQueue_push(queue, (dc_InputEvent){.time = time, .aim = aim, .kind = DC_INPUT_AIM});
+  }
+  queue->pressed |= down & ~queue->sampled;
+  queue->sampled = down;
+  queue->sampled_aim = aim;
+  queue->sampled_time = time;
+}
+
+dc_InputStep dc_InputQueue_take(dc_InputQueue* queue, double until) {
+  dc_InputStep step = {.pressed = queue->folded_pressed};
+  queue->folded_pressed = 0;
+  unsigned int taken = 0;
+  while(taken < queue->count && queue->events[taken].time <= until) {
+    dc_InputQueue_apply(queue, queue->events[taken], &step);
+    taken++;
+  }
+  queue->count -= taken;
+  memmove(queue->events, queue->events + taken, queue->count * sizeof(dc_InputEvent));
+  step.held = queue->held;
+  step.aim = queue->aim;
+  return step;
+}
+
+uint32_t dc_InputQueue_pressed(dc_InputQueue* queue) {
+  uint32_t pressed = queue->pressed;
+  queue->pressed = 0;
+  return pressed;
+}
+
+void dc_Latency_add(dc_Latency* latency, double seconds) {
+  latency->total += seconds;
+  if(seconds > latency->max) latency->max = seconds;
+  latency->count++;
+}
+
+double dc_Latency_mean_ms(const dc_Latency* latency) {
+  return latency->count ? latency->total / latency->count * 1000 : 0;
+}
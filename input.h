@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+#include "dc.h"
+
+#define DC_INPUT_QUEUE_SIZE 64
+
+typedef enum {
+  DC_INPUT_DOWN,
+  DC_INPUT_UP,
+  DC_INPUT_AIM
+} dc_InputEventKind;
+
+// one change in what's held or where the mouse is, stamped with when we saw it
+typedef struct {
+  double time; // dc_time_now()
+  Vector2 aim; // DC_INPUT_AIM only, virtual SCREEN_WIDTH x SCREEN_HEIGHT space
+  uint8_t kind; // dc_InputEventKind
+  uint8_t control; // DC_INPUT_DOWN/UP, which bit of the held mask changed
+} dc_InputEvent;
+
+// everything that happened since the last step, in the order it happened. controls are just
+// bit numbers here, whoever samples decides which keys and buttons they stand for. polling can
+// happen as often as it likes, each sample only adds the changes since the one before
+typedef struct {
+  dc_InputEvent events[DC_INPUT_QUEUE_SIZE];
+  unsigned int count;
+  // state once every event so far has been taken, which is what the next step starts from
+  uint32_t held;
+  Vector2 aim;
+  uint32_t folded_pressed; // presses out of events folded in early, the next take still sees them
+  // state as of the last sample, which is what new samples are diffed against
+  uint32_t sampled;
+  Vector2 sampled_aim;
+  double sampled_time;
+  uint32_t pressed; // went down since the last dc_InputQueue_pressed, for per frame toggles
+  unsigned long folded; // events applied early because the queue was full
+} dc_InputQueue;
+
+// what one step gets out of the queue
+typedef struct {
+  uint32_t held; // down at the end of the step
+  uint32_t pressed; // went down at some point in the step, even if it's already back up
+  Vector2 aim; // the latest one
+  double first_press; // when the earliest press happened, 0 if there wasn't one
+} dc_InputStep;
+
+void dc_InputQueue_init(dc_InputQueue* queue, Vector2 aim);
+// diffs down and aim against the last sample and queues what changed at `time`
+void dc_InputQueue_sample(dc_InputQueue* queue, double time, uint32_t down, Vector2 aim);
+// everything that happened up to and including `until`, anything later stays queued
+dc_InputStep dc_InputQueue_take(dc_InputQueue* queue, double until);
+// what went down since the last call
+uint32_t dc_InputQueue_pressed(dc_InputQueue* queue);
+
+// how old input is by the time the frame showing it gets presented
+typedef struct {
+  double total;
+  double max;
+  unsigned long count;
+} dc_Latency;
+
+void dc_Latency_add(dc_Latency* latency, double seconds);
+// in milliseconds, 0 with nothing added yet
+double dc_Latency_mean_ms(const dc_Latency* latency);
@@ -0,0 +1,186 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "jobs.h"
+
+#define DC_JOBS_MAX_WORKERS 64
+
+typedef struct {
+  dc_JobFn fn;
+  void* ctx;
+  unsigned int begin;
+  unsigned int end;
+} dc_Chunk;
+
+// the owner pops from the back, thieves take from the front. chunks are coarse enough that a
+// plain mutex per deque never shows up in a profile
+typedef struct {
+  pthread_mutex_t lock;
+  dc_Chunk* items;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int capacity;
+} dc_Deque;
+
+static struct {
+  unsigned int worker_count; // including the thread that calls dc_jobs_parallel_for
+  pthread_t threads[DC_JOBS_MAX_WORKERS];
+  dc_Deque deques[DC_JOBS_MAX_WORKERS];
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  unsigned long generation;
+  bool quit;
+  bool running;
+  unsigned int chunks_left;
+} dc_pool = {.worker_count = 1};
+
+static bool dc_Deque_pop_back(dc_Deque* d, dc_Chunk* out) {
+  pthread_mutex_lock(&d->lock);
+  bool ok = d->tail > d->head;
+  if(ok) *out = d->items[--d->tail];
+  pthread_mutex_unlock(&d->lock);
+  return ok;
+}
+
+static bool dc_Deque_steal(dc_Deque* d, dc_Chunk* out) {
+  pthread_mutex_lock(&d->lock);
+  bool ok = d->tail > d->head;
+  if(ok) *out = d->items[d->head++];
+  pthread_mutex_unlock(&d->lock);
+  return ok;
+}
+
+static void dc_jobs_work(unsigned int worker) {
+  dc_Chunk chunk;
+  for(;;) {
+    bool found = dc_Deque_pop_back(&dc_pool.deques[worker], &chunk);
+    for(unsigned int v = 1; !found && v < dc_pool.worker_count; v++) {
+      found = dc_Deque_steal(&dc_pool.deques[(worker + v) % dc_pool.worker_count], &chunk);
+    }
+    if(!found) return;
+
+    chunk.fn(chunk.ctx, chunk.begin, chunk.end, worker);
+    if(__atomic_sub_fetch(&dc_pool.chunks_left, 1, __ATOMIC_ACQ_REL) == 0) {
+      pthread_mutex_lock(&dc_pool.lock);
+      pthread_cond_broadcast(&dc_pool.done);
+      pthread_mutex_unlock(&dc_pool.lock);
+    }
+  }
+}
+
+static void* dc_jobs_thread(void* arg) {
+  unsigned int worker = (unsigned int)(uintptr_t)arg;
+  unsigned long seen = 0;
+  for(;;) {
+    pthread_mutex_lock(&dc_pool.lock);
+    while(dc_pool.generation == seen && !dc_pool.quit) pthread_cond_wait(&dc_pool.wake, &dc_pool.lock);
+    bool quit = dc_pool.quit;
+    seen = dc_pool.generation;
+    pthread_mutex_unlock(&dc_pool.lock);
+    if(quit) return NULL;
+    dc_jobs_work(worker);
+  }
+}
+
+void dc_jobs_init(unsigned int threads) {
+  if(dc_pool.running) dc_jobs_shutdown();
+  if(threads == 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cores > 0 ? cores : 1;
+#else
+    threads = 4;
+#endif
+  }
+  if(threads > DC_JOBS_MAX_WORKERS) threads = DC_JOBS_MAX_WORKERS;
+
+  pthread_mutex_init(&dc_pool.lock, NULL);
+  pthread_cond_init(&dc_pool.wake, NULL);
+  pthread_cond_init(&dc_pool.done, NULL);
+  dc_pool.generation = 0;
+  dc_pool.quit = false;
+  for(unsigned int w = 0; w < threads; w++) {
+    dc_pool.deques[w] = (dc_Deque){0};
+    pthread_mutex_init(&dc_pool.deques[w].lock, NULL);
+  }
+  dc_pool.worker_count = 1;
+  dc_pool.running = true;
+  for(unsigned int w = 1; w < threads; w++) {
+    if(pthread_create(&dc_pool.threads[w], NULL, dc_jobs_thread, (void*)(uintptr_t)w) != 0) break;
+    dc_pool.worker_count++;
+  }
+}
+
+void dc_jobs_shutdown(void) {
+  if(!dc_pool.running) return;
+  pthread_mutex_lock(&dc_pool.lock);
+  dc_pool.quit = true;
+  pthread_cond_broadcast(&dc_pool.wake);
+  pthread_mutex_unlock(&dc_pool.lock);
+  for(unsigned int w = 1; w < dc_pool.worker_count; w++) {
+    pthread_join(dc_pool.threads[w], NULL);
+  }
+  for(unsigned int w = 0; w < dc_pool.worker_count; w++) {
+    free(dc_pool.deques[w].items);
+    pthread_mutex_destroy(&dc_pool.deques[w].lock);
+  }
+  pthread_cond_destroy(&dc_pool.done);
+  pthread_cond_destroy(&dc_pool.wake);
+  pthread_mutex_destroy(&dc_pool.lock);
+  dc_pool.worker_count = 1;
+  dc_pool.running = false;
+}
+
+unsigned int dc_jobs_worker_count(void) {
+  return dc_pool.worker_count;
+}
+
+unsigned int dc_jobs_chunk_count(unsigned int count, unsigned int grain) {
+  return (count + grain - 1) / grain;
+}
+
+void dc_jobs_parallel_for(unsigned int count, unsigned int grain, dc_JobFn fn, void* ctx) {
+  unsigned int chunks = dc_jobs_chunk_count(count, grain);
+  // not worth waking anyone up for
+  if(dc_pool.worker_count <= 1 || chunks <= 1) {
+    for(unsigned int begin = 0; begin < count; begin += grain) {
+      fn(ctx, begin, begin + grain < count ? begin + grain : count, 0);
+    }
+    return;
+  }
+
+  // a worker still finishing up the last job can be poking at the deques and grab a chunk the
+  // moment it lands, so the count goes up first and the deques get filled under their locks
+  __atomic_store_n(&dc_pool.chunks_left, chunks, __ATOMIC_RELEASE);
+  unsigned int workers = dc_pool.worker_count;
+  for(unsigned int w = 0; w < workers; w++) {
+    dc_Deque* d = &dc_pool.deques[w];
+    pthread_mutex_lock(&d->lock);
+    unsigned int needed = chunks / workers + 1;
+    if(d->capacity < needed) {
+      d->capacity = needed * 2;
+      d->items = realloc(d->items, sizeof(dc_Chunk) * d->capacity);
+    }
+    d->head = d->tail = 0;
+    for(unsigned int c = w; c < chunks; c += workers) {
+      unsigned int begin = c * grain;
+      d->items[d->tail++] = (dc_Chunk){fn, ctx, begin, begin + grain < count ? begin + grain : count};
+    }
+    pthread_mutex_unlock(&d->lock);
+  }
+
+  pthread_mutex_lock(&dc_pool.lock);
+  dc_pool.generation++;
+  pthread_cond_broadcast(&dc_pool.wake);
+  pthread_mutex_unlock(&dc_pool.lock);
+
+  dc_jobs_work(0);
+
+  pthread_mutex_lock(&dc_pool.lock);
+  while(__atomic_load_n(&dc_pool.chunks_left, __ATOMIC_ACQUIRE) > 0) pthread_cond_wait(&dc_pool.done, &dc_pool.lock);
+  pthread_mutex_unlock(&dc_pool.lock);
+}
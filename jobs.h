@@ -0,0 +1,17 @@
+#pragma once
+
+// runs fn over [begin, end) of a bigger range. worker is 0 for the calling thread and
+// 1..dc_jobs_worker_count()-1 for the pool threads, so jobs can keep per-worker scratch
+typedef void (*dc_JobFn)(void* ctx, unsigned int begin, unsigned int end, unsigned int worker);
+
+// starts threads - 1 pool threads (0 = one per core). safe to skip, everything then runs inline
+void dc_jobs_init(unsigned int threads);
+void dc_jobs_shutdown(void);
+unsigned int dc_jobs_worker_count(void);
+
+// splits [0, count) into chunks of `grain` and hands them out round robin. idle workers steal
+// from the others, and it returns once every chunk has run. chunk k is always
+// [k * grain, min((k + 1) * grain, count)) whatever the thread count, so jobs that write
+// per-chunk results and merge them in chunk order get the same answer with 1 thread or 64
+void dc_jobs_parallel_for(unsigned int count, unsigned int grain, dc_JobFn fn, void* ctx);
+unsigned int dc_jobs_chunk_count(unsigned int count, unsigned int grain);
@@ -0,0 +1,213 @@
+#include <math.h>
+#include <string.h>
+#include "kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define DC_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+// scalar
+
+static Vector2 dc_direction_scalar(Vector2 from, Vector2 to) {
+  float dx = to.x - from.x;
+  float dy = to.y - from.y;
+  float len2 = dx * dx + dy * dy;
+  if(len2 <= 0) return (Vector2){1, 0}; // what atan2(0, 0) used to give us
+  float r = 1.f / sqrtf(len2);
+  return (Vector2){dx * r, dy * r};
+}
+
+static void dc_seek_scalar(const Vector2* position, Vector2* velocity, const dc_AiKind* ai, const float* iframe_time_remaining, unsigned int count, Vector2 target, float speed) {
+  for(unsigned int i = 0; i < count; i++) {
+    if(ai[i] != DC_AI_BAT || iframe_time_remaining[i] > 0) continue;
+    Vector2 d = dc_direction_scalar(position[i], target);
+    velocity[i] = (Vector2){d.x * speed, d.y * speed};
+  }
+}
+
+static void dc_integrate_scalar(Vector2* position, const Vector2* velocity, unsigned int count, float dt) {
+  for(unsigned int i = 0; i < count; i++) {
+    position[i].x += velocity[i].x * dt;
+    position[i].y += velocity[i].y * dt;
+  }
+}
+
+static void dc_tick_timers_scalar(float* time_until_next_frame, float* iframe_time_remaining, unsigned int count, float dt) {
+  for(unsigned int i = 0; i < count; i++) {
+    time_until_next_frame[i] -= dt;
+    if(iframe_time_remaining[i] > 0) iframe_time_remaining[i] -= dt;
+  }
+}
+
+static const dc_Kernels dc_kernels_scalar = {"scalar", dc_seek_scalar, dc_integrate_scalar, dc_tick_timers_scalar, dc_direction_scalar};
+
+#ifdef DC_KERNELS_X86
+
+// sse2: four actors a pass. x/y come in interleaved, so deinterleave with shuffles, do the
+// math on four xs and four ys, then unpack back. tails go through the scalar code, which
+// rounds the same as every lane
+
+static inline __m128 dc_rsqrt_ps(__m128 len2) {
+  // sqrtps and divps round exactly like 1.f / sqrtf, which rsqrtps doesn't: its bits are up to
+  // the cpu, and the sim has to come out the same everywhere
+  return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(len2));
+}
+
+static void dc_seek_sse2(const Vector2* position, Vector2* velocity, const dc_AiKind* ai, const float* iframe_time_remaining, unsigned int count, Vector2 target, float speed) {
+  const __m128 tx = _mm_set1_ps(target.x);
+  const __m128 ty = _mm_set1_ps(target.y);
+  const __m128 spd = _mm_set1_ps(speed);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128i bat = _mm_set1_epi32(DC_AI_BAT);
+  unsigned int i = 0;
+  for(; i + 4 <= count; i += 4) {
+    __m128 p01 = _mm_loadu_ps(&position[i].x);
+    __m128 p23 = _mm_loadu_ps(&position[i + 2].x);
+    __m128 dx = _mm_sub_ps(tx, _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128 dy = _mm_sub_ps(ty, _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1)));
+    __m128 len2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    __m128 r = dc_rsqrt_ps(len2);
+    __m128 nonzero = _mm_cmpgt_ps(len2, zero);
+    __m128 vx = _mm_or_ps(_mm_and_ps(nonzero, _mm_mul_ps(_mm_mul_ps(dx, r), spd)), _mm_andnot_ps(nonzero, spd));
+    __m128 vy = _mm_and_ps(nonzero, _mm_mul_ps(_mm_mul_ps(dy, r), spd));
+
+    __m128 is_bat = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&ai[i]), bat));
+    __m128 active = _mm_and_ps(is_bat, _mm_cmple_ps(_mm_loadu_ps(&iframe_time_remaining[i]), zero));
+    __m128 m01 = _mm_unpacklo_ps(active, active);
+    __m128 m23 = _mm_unpackhi_ps(active, active);
+    __m128 old01 = _mm_loadu_ps(&velocity[i].x);
+    __m128 old23 = _mm_loadu_ps(&velocity[i + 2].x);
+    _mm_storeu_ps(&velocity[i].x, _mm_or_ps(_mm_and_ps(m01, _mm_unpacklo_ps(vx, vy)), _mm_andnot_ps(m01, old01)));
+    _mm_storeu_ps(&velocity[i + 2].x, _mm_or_ps(_mm_and_ps(m23, _mm_unpackhi_ps(vx, vy)), _mm_andnot_ps(m23, old23)));
+  }
+  for(; i < count; i++) {
+    if(ai[i] != DC_AI_BAT || iframe_time_remaining[i] > 0) continue;
+    Vector2 d = dc_direction_scalar(position[i], target);
+    velocity[i] = (Vector2){d.x * speed, d.y * speed};
+  }
+}
+
+static void dc_integrate_sse2(Vector2* position, const Vector2* velocity, unsigned int count, float dt) {
+  float* p = &position->x;
+  const float* v = &velocity->x;
+  unsigned int n = count * 2;
+  const __m128 step = _mm_set1_ps(dt);
+  unsigned int i = 0;
+  for(; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(p + i, _mm_add_ps(_mm_loadu_ps(p + i), _mm_mul_ps(_mm_loadu_ps(v + i), step)));
+  }
+  for(; i < n; i++) p[i] += v[i] * dt;
+}
+
+static void dc_tick_timers_sse2(float* time_until_next_frame, float* iframe_time_remaining, unsigned int count, float dt) {
+  const __m128 step = _mm_set1_ps(dt);
+  const __m128 zero = _mm_setzero_ps();
+  unsigned int i = 0;
+  for(; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(time_until_next_frame + i, _mm_sub_ps(_mm_loadu_ps(time_until_next_frame + i), step));
+    __m128 t = _mm_loadu_ps(iframe_time_remaining + i);
+    _mm_storeu_ps(iframe_time_remaining + i, _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, zero), step)));
+  }
+  dc_tick_timers_scalar(time_until_next_frame + i, iframe_time_remaining + i, count - i, dt);
+}
+
+static const dc_Kernels dc_kernels_sse2 = {"sse2", dc_seek_sse2, dc_integrate_sse2, dc_tick_timers_sse2, dc_direction_scalar};
+
+// avx2: eight actors a pass. the 256 bit shuffles work per 128 bit half, so the xs come out as
+// 0 1 4 5 | 2 3 6 7; the per-actor masks get permuted to match and unpacking undoes it
+
+#define DC_AVX2 __attribute__((target("avx2")))
+
+DC_AVX2 static inline __m256 dc_rsqrt_ps256(__m256 len2) {
+  return _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_sqrt_ps(len2));
+}
+
+DC_AVX2 static void dc_seek_avx2(const Vector2* position, Vector2* velocity, const dc_AiKind* ai, const float* iframe_time_remaining, unsigned int count, Vector2 target, float speed) {
+  const __m256 tx = _mm256_set1_ps(target.x);
+  const __m256 ty = _mm256_set1_ps(target.y);
+  const __m256 spd = _mm256_set1_ps(speed);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256i bat = _mm256_set1_epi32(DC_AI_BAT);
+  const __m256i lane_order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+  unsigned int i = 0;
+  for(; i + 8 <= count; i += 8) {
+    __m256 p03 = _mm256_loadu_ps(&position[i].x);
+    __m256 p47 = _mm256_loadu_ps(&position[i + 4].x);
+    __m256 dx = _mm256_sub_ps(tx, _mm256_shuffle_ps(p03, p47, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m256 dy = _mm256_sub_ps(ty, _mm256_shuffle_ps(p03, p47, _MM_SHUFFLE(3, 1, 3, 1)));
+    __m256 len2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    __m256 r = dc_rsqrt_ps256(len2);
+    __m256 nonzero = _mm256_cmp_ps(len2, zero, _CMP_GT_OQ);
+    __m256 vx = _mm256_blendv_ps(spd, _mm256_mul_ps(_mm256_mul_ps(dx, r), spd), nonzero);
+    __m256 vy = _mm256_and_ps(nonzero, _mm256_mul_ps(_mm256_mul_ps(dy, r), spd));
+
+    __m256 is_bat = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)&ai[i]), bat));
+    __m256 active = _mm256_and_ps(is_bat, _mm256_cmp_ps(_mm256_loadu_ps(&iframe_time_remaining[i]), zero, _CMP_LE_OQ));
+    active = _mm256_permutevar8x32_ps(active, lane_order);
+    __m256 old03 = _mm256_loadu_ps(&velocity[i].x);
+    __m256 old47 = _mm256_loadu_ps(&velocity[i + 4].x);
+    _mm256_storeu_ps(&velocity[i].x, _mm256_blendv_ps(old03, _mm256_unpacklo_ps(vx, vy), _mm256_unpacklo_ps(active, active)));
+    _mm256_storeu_ps(&velocity[i + 4].x, _mm256_blendv_ps(old47, _mm256_unpackhi_ps(vx, vy), _mm256_unpackhi_ps(active, active)));
+  }
+  dc_seek_sse2(position + i, velocity + i, ai + i, iframe_time_remaining + i, count - i, target, speed);
+}
+
+DC_AVX2 static void dc_integrate_avx2(Vector2* position, const Vector2* velocity, unsigned int count, float dt) {
+  float* p = &position->x;
+  const float* v = &velocity->x;
+  unsigned int n = count * 2;
+  const __m256 step = _mm256_set1_ps(dt);
+  unsigned int i = 0;
+  for(; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(p + i, _mm256_add_ps(_mm256_loadu_ps(p + i), _mm256_mul_ps(_mm256_loadu_ps(v + i), step)));
+  }
+  for(; i < n; i++) p[i] += v[i] * dt;
+}
+
+DC_AVX2 static void dc_tick_timers_avx2(float* time_until_next_frame, float* iframe_time_remaining, unsigned int count, float dt) {
+  const __m256 step = _mm256_set1_ps(dt);
+  const __m256 zero = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for(; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(time_until_next_frame + i, _mm256_sub_ps(_mm256_loadu_ps(time_until_next_frame + i), step));
+    __m256 t = _mm256_loadu_ps(iframe_time_remaining + i);
+    _mm256_storeu_ps(iframe_time_remaining + i, _mm256_sub_ps(t, _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_GT_OQ), step)));
+  }
+  dc_tick_timers_scalar(time_until_next_frame + i, iframe_time_remaining + i, count - i, dt);
+}
+
+static const dc_Kernels dc_kernels_avx2 = {"avx2", dc_seek_avx2, dc_integrate_avx2, dc_tick_timers_avx2, dc_direction_scalar};
+
+#endif
+
+dc_Kernels dc_kernels = {"scalar", dc_seek_scalar, dc_integrate_scalar, dc_tick_timers_scalar, dc_direction_scalar};
+
+unsigned int dc_kernels_available(const dc_Kernels** out, unsigned int max) {
+  unsigned int n = 0;
+  if(n < max) out[n++] = &dc_kernels_scalar;
+#ifdef DC_KERNELS_X86
+  if(n < max) out[n++] = &dc_kernels_sse2;
+  __builtin_cpu_init();
+  if(n < max && __builtin_cpu_supports("avx2")) out[n++] = &dc_kernels_avx2;
+#endif
+  return n;
+}
+
+void dc_kernels_init(void) {
+  const dc_Kernels* available[4];
+  unsigned int n = dc_kernels_available(available, 4);
+  dc_kernels = *available[n - 1];
+}
+
+bool dc_kernels_select(const char* name) {
+  const dc_Kernels* available[4];
+  unsigned int n = dc_kernels_available(available, 4);
+  for(unsigned int k = 0; k < n; k++) {
+    if(strcmp(available[k]->name, name) == 0) {
+      dc_kernels = *available[k];
+      return true;
+    }
+  }
+  return false;
+}
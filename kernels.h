@@ -0,0 +1,25 @@
+#pragma once
+#include "actors.h"
+
+// batch math over the packed actor arrays. dc_kernels starts out as the plain C version and
+// dc_kernels_init() swaps in the widest one the cpu can run. they all do the same operations in
+// the same order with correctly rounded ops, so every one of them gives the same bits
+typedef struct {
+  const char* name;
+  // velocity = speed * direction from position to target, for every DC_AI_BAT not in iframes
+  void (*seek)(const Vector2* position, Vector2* velocity, const dc_AiKind* ai, const float* iframe_time_remaining, unsigned int count, Vector2 target, float speed);
+  // position += velocity * dt
+  void (*integrate)(Vector2* position, const Vector2* velocity, unsigned int count, float dt);
+  // time_until_next_frame -= dt everywhere, iframe_time_remaining -= dt wherever it's still above 0
+  void (*tick_timers)(float* time_until_next_frame, float* iframe_time_remaining, unsigned int count, float dt);
+  // unit vector from -> to, rounded exactly like seek. points along +x when from == to
+  Vector2 (*direction)(Vector2 from, Vector2 to);
+} dc_Kernels;
+
+extern dc_Kernels dc_kernels;
+
+void dc_kernels_init(void);
+// force a particular implementation ("scalar", "sse2", "avx2"), false if this cpu/build can't run it
+bool dc_kernels_select(const char* name);
+// every implementation this cpu can run, narrowest first. returns how many
+unsigned int dc_kernels_available(const dc_Kernels** out, unsigned int max);
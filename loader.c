@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "loader.h"
+#include "jobs.h"
+#include "dc.h"
+
+bool dc_assets_check(const dc_Pack* pack, const dc_AssetLoad* loads, unsigned int count) {
+  bool ok = true;
+  for(unsigned int l = 0; l < count; l++) {
+    if(dc_Pack_find(pack, loads[l].name, NULL) == NULL) {
+      fprintf(stderr, "%s isn't in the asset pack, rebuild it with `make`\n", loads[l].name);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+static void dc_AssetLoad_decode(dc_AssetLoad* load, const dc_Pack* pack) {
+  double start = dc_time_now();
+  unsigned int size;
+  const unsigned char* data = dc_Pack_find(pack, load->name, &size);
+  const char* type = strrchr(load->name, '.');
+  switch(load->kind) {
+    case DC_ASSET_IMAGE:
+      load->image = LoadImageFromMemory(type, data, size);
+      break;
+    case DC_ASSET_FONT:
+      // what LoadFontFromMemory does, minus the texture upload at the end
+      load->glyph_count = FONT_GLYPH_COUNT;
+      load->glyphs = LoadFontData(data, size, load->font_size, NULL, FONT_GLYPH_COUNT, 0);
+      load->image = GenImageFontAtlas(load->glyphs, &load->glyph_recs, FONT_GLYPH_COUNT, load->font_size, FONT_GLYPH_PADDING, 0);
+      break;
+    case DC_ASSET_STREAM:
+      load->data = data;
+      load->size = size;
+      break;
+  }
+  load->decode_time = dc_time_now() - start;
+}
+
+typedef struct {
+  const dc_Pack* pack;
+  dc_AssetLoad* loads;
+  unsigned int* decoded;
+} dc_DecodeJob;
+
+static void dc_decode_job(void* ctx, unsigned int begin, unsigned int end, unsigned int worker) {
+  dc_DecodeJob* job = ctx;
+  for(unsigned int l = begin; l < end; l++) {
+    dc_AssetLoad_decode(&job->loads[l], job->pack);
+    if(job->decoded) __atomic_add_fetch(job->decoded, 1, __ATOMIC_RELEASE);
+  }
+}
+
+static void dc_assets_decode_counted(const dc_Pack* pack, dc_AssetLoad* loads, unsigned int count, bool parallel, unsigned int* decoded) {
+  dc_DecodeJob job = {pack, loads, decoded};
+  // one asset per chunk, they're few and wildly different sizes
+  if(parallel) dc_jobs_parallel_for(count, 1, dc_decode_job, &job);
+  else dc_decode_job(&job, 0, count, 0);
+}
+
+void dc_assets_decode(const dc_Pack* pack, dc_AssetLoad* loads, unsigned int count, bool parallel) {
+  dc_assets_decode_counted(pack, loads, count, parallel, NULL);
+}
+
+static void* dc_Loader_thread(void* arg) {
+  dc_Loader* loader = arg;
+  dc_assets_decode_counted(loader->pack, loader->loads, loader->count, loader->parallel, &loader->decoded);
+  return NULL;
+}
+
+void dc_Loader_start(dc_Loader* loader, const dc_Pack* pack, dc_AssetLoad* loads, unsigned int count, bool parallel) {
+  *loader = (dc_Loader){.pack = pack, .loads = loads, .count = count, .parallel = parallel};
+  // no thread, no loading screen. decode it right here
+  loader->started = pthread_create(&loader->thread, NULL, dc_Loader_thread, loader) == 0;
+  if(!loader->started) dc_Loader_thread(loader);
+}
+
+float dc_Loader_progress(const dc_Loader* loader) {
+  if(loader->count == 0) return 1.f;
+  return __atomic_load_n(&loader->decoded, __ATOMIC_ACQUIRE) / (float)loader->count;
+}
+
+bool dc_Loader_done(const dc_Loader* loader) {
+  return __atomic_load_n(&loader->decoded, __ATOMIC_ACQUIRE) == loader->count;
+}
+
+void dc_Loader_wait(dc_Loader* loader) {
+  if(loader->started) pthread_join(loader->thread, NULL);
+  loader->started = false;
+}
+
+Texture2D dc_AssetLoad_texture(dc_AssetLoad* load) {
+  Texture2D texture = LoadTextureFromImage(load->image);
+  UnloadImage(load->image);
+  load->image = (Image){0};
+  return texture;
+}
+
+Font dc_AssetLoad_font(dc_AssetLoad* load) {
+  Font font = {
+    .baseSize = load->font_size,
+    .glyphCount = load->glyph_count,
+    .glyphPadding = FONT_GLYPH_PADDING,
+    .texture = LoadTextureFromImage(load->image),
+    .recs = load->glyph_recs,
+    .glyphs = load->glyphs
+  };
+  // the font owns the glyphs and recs now, UnloadFont frees them
+  UnloadImage(load->image);
+  *load = (dc_AssetLoad){.name = load->name, .kind = load->kind, .font_size = load->font_size};
+  return font;
+}
+
+void dc_AssetLoad_free(dc_AssetLoad* load) {
+  UnloadImage(load->image);
+  if(load->glyphs) UnloadFontData(load->glyphs, load->glyph_count);
+  free(load->glyph_recs);
+  *load = (dc_AssetLoad){.name = load->name, .kind = load->kind, .font_size = load->font_size};
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <raylib.h>
+#include <pthread.h>
+#include "pack.h"
+
+// raylib's LoadFontFromMemory packs these with the same padding, keeping it identical means the
+// glyphs land in the same spots
+#define FONT_GLYPH_PADDING 4
+#define FONT_GLYPH_COUNT 95
+
+typedef enum {
+  DC_ASSET_IMAGE,
+  DC_ASSET_FONT,
+  DC_ASSET_STREAM // left compressed, decoded bit by bit as it plays
+} dc_AssetKind;
+
+// one asset to pull out of the pack. decoding only touches the cpu side (Image, glyphs) so it
+// can happen on any thread, the gpu upload happens on the main thread after
+typedef struct {
+  const char* name;
+  dc_AssetKind kind;
+  int font_size; // DC_ASSET_FONT only
+
+  Image image; // the picture, or the glyph atlas for fonts
+  GlyphInfo* glyphs;
+  Rectangle* glyph_recs;
+  int glyph_count;
+  const unsigned char* data; // DC_ASSET_STREAM only, points into the pack
+  unsigned int size;
+  double decode_time; // seconds spent in this asset's decode
+} dc_AssetLoad;
+
+typedef struct {
+  const dc_Pack* pack;
+  dc_AssetLoad* loads;
+  unsigned int count;
+  bool parallel;
+  pthread_t thread;
+  unsigned int decoded; // bumped atomically as each load finishes
+  bool started;
+} dc_Loader;
+
+// false (with a message on stderr) if anything's missing from the pack, checked up front so
+// the decode never has to bail out from a worker
+bool dc_assets_check(const dc_Pack* pack, const dc_AssetLoad* loads, unsigned int count);
+// decodes everything on the calling thread, or spread over the job system when parallel
+void dc_assets_decode(const dc_Pack* pack, dc_AssetLoad* loads, unsigned int count, bool parallel);
+
+// the same as dc_assets_decode but on a background thread, so the main thread can keep drawing a
+// loading screen. nothing else may use the job system until dc_Loader_wait returns
+void dc_Loader_start(dc_Loader* loader, const dc_Pack* pack, dc_AssetLoad* loads, unsigned int count, bool parallel);
+float dc_Loader_progress(const dc_Loader* loader); // 0..1
+bool dc_Loader_done(const dc_Loader* loader);
+void dc_Loader_wait(dc_Loader* loader);
+
+// main thread only. these hand the decoded data over to the gpu and free what's no longer
+// needed on the cpu side
+Texture2D dc_AssetLoad_texture(dc_AssetLoad* load);
+Font dc_AssetLoad_font(dc_AssetLoad* load);
+// throws away whatever decode produced, for when nothing got uploaded
+void dc_AssetLoad_free(dc_AssetLoad* load);
@@ -1,111 +1,74 @@
 #include <raylib.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
 #include <math.h>
 #include <time.h>
 #include "mo_colors.h"
-
-#define SCREEN_WIDTH  320
-#define SCREEN_HEIGHT 180
-#define TILE_WIDTH 16.f
-#define TILE_HEIGHT 24.f
-#define TILE_ORIGIN ((Vector2){TILE_WIDTH / 2.f, TILE_HEIGHT / 2.f})
-#define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
-#define MAX_FRAMES 4
-#define MAX_ACTORS 128
-#define IFRAME_DURATION 1.f
-#define IFRAME_FLASH_SPEED 4.f // N times a second
-#define FLOOR_WIDTH 7
-#define FLOOR_HEIGHT 7
-#define ROOMS_LENGTH (FLOOR_WIDTH * FLOOR_HEIGHT)
-#define ROOMS_TO_WIN 10
-
-#define COL_LAYER_PLAYER 1 // 0b01
-#define COL_LAYER_ENEMY 2 //  0b10
-
-typedef struct {
-  Texture2D interface;
-  // Texture2D terrain;
-  // Texture2D monsters;
-  Texture2D avatar;
-  Texture2D fx_general;
-
-  Texture2D zach;
-} dc_Tilesets;
-
+#include "dc.h"
+#include "sim.h"
+#include "kernels.h"
+#include "jobs.h"
+#include "atlas.h"
+#include "pack.h"
+#include "loader.h"
+#include "prof.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "mixer.h"
+#include "draw.h"
+#include "drawlist.h"
+#include "input.h"
+
+#define REWIND_FRAMES (10 * SIM_HZ) // ten seconds of sim steps, a few kb each
+#define QUICKSAVE_PATH "quicksave.dcs"
+#define DC_WIN_TEXT "You escaped the dungeon and \nenacted revenge on \nthe town of adventurers.\n\nYou win!"
+
+#define MIXER_MAX_PLAYING 24
+
+// every sound the game has, sfx/ only ships the door. anything new goes in here and gets its own
+// dc_Mixer_add below, the voices and priority are what decide who loses out when it's busy
 typedef struct {
-  Sound door_open;
+  int door_open;
 } dc_Sounds;
 
-typedef struct {
-  Texture2D skeleton_textures[MAX_FRAMES];
-  Rectangle skeleton_rects[MAX_FRAMES];
-  unsigned int skeleton_frames;
-  Texture2D slice_textures[MAX_FRAMES];
-  Rectangle slice_rects[MAX_FRAMES];
-  unsigned int slice_frames;
-  Texture2D dwarf_textures[MAX_FRAMES];
-  Rectangle dwarf_rects[MAX_FRAMES];
-  unsigned int dwarf_frames;
-} dc_Frames;
-
-typedef struct {
-  bool door_north;
-  bool door_south;
-  bool door_east;
-  bool door_west;
-  unsigned int remaining_monsters;
-  bool doors_opened;
-} dc_Room;
-
-typedef struct dc_Actor_s {
-  Texture2D* textures;
-  Rectangle* sources;
-  Color color;
-  Vector2 position;
-  Vector2 velocity;
-  Vector2 origin;
-  float rotation;
-  float time_per_frame;
-  float time_until_next_frame;
-  unsigned int current_frame;
-  bool has_shadow;
-  Vector2 shadow_offset;
-  unsigned int frame_count;
-  bool free_on_anim_comp;
-  bool should_be_freed;
-  unsigned int collision_layer;
-  unsigned int collision_mask;
-  int collision_damage;
-  float iframe_time_remaining;
-  int hp;
-  int hp_max;
-  void (*ai)(struct dc_Actor_s* self, struct dc_Actor_s* player);
-} dc_Actor;
-
-float dc_clampf(float n, float min, float max) {
-  return min > n ? min : max < n ? max : n;
+// everything the window build loads, all out of assets.pak
+typedef enum {
+  ASSET_ICON,
+  ASSET_ATLAS,
+  ASSET_FONT,
+  ASSET_DOOR_OPEN,
+  ASSET_COUNT
+} dc_GameAsset;
+
+static const dc_AssetLoad dc_game_assets[ASSET_COUNT] = {
+  [ASSET_ICON] = {.name = "gfx/gmtk_icon.png", .kind = DC_ASSET_IMAGE},
+  [ASSET_ATLAS] = {.name = "gfx/atlas.png", .kind = DC_ASSET_IMAGE},
+  [ASSET_FONT] = {.name = "gfx/perfect_dos_vga_437.ttf", .kind = DC_ASSET_FONT, .font_size = 16*4},
+  [ASSET_DOOR_OPEN] = {.name = "sfx/door_open.ogg", .kind = DC_ASSET_STREAM}
+};
+
+// next to the executable rather than wherever we got launched from
+// path is NULL for the assets.pak next to the executable
+bool dc_open_assets(dc_Pack* pack, const char* path) {
+  if(!dc_Pack_open(pack, path ? path : TextFormat("%sassets.pak", GetApplicationDirectory()))) return false;
+  if(!dc_assets_check(pack, dc_game_assets, ASSET_COUNT)) {
+    dc_Pack_close(pack);
+    return false;
+  }
+  return true;
 }
 
 Vector2 dc_get_screen_scaling_percent(void) {
   return (Vector2){SCREEN_WIDTH / (float)GetScreenWidth(), SCREEN_HEIGHT / (float)GetScreenHeight()};
 }
 
-double dc_get_vector_length(Vector2 v) {
-  return v.x * v.x + v.y * v.y; 
-}
-
-Vector2 dc_normalize_vector(Vector2 v) {
-  double length = dc_get_vector_length(v);
-  return (Vector2){v.x / length, v.y / length};
-}
-
-Vector2 dc_get_direction_to(Vector2 from, Vector2 to) {
-  float dx = to.x - from.x;
-  float dy = to.y - from.y;
-  float rot = atan2(dy, dx);
-  return (Vector2){cos(rot), sin(rot)};
+// the mouse in virtual SCREEN_WIDTH x SCREEN_HEIGHT space
+Vector2 dc_get_virtual_mouse(void) {
+  Vector2 mouse_pos = GetMousePosition();
+  Vector2 screen_scaling = dc_get_screen_scaling_percent();
+  return (Vector2){mouse_pos.x * screen_scaling.x, mouse_pos.y * screen_scaling.y};
 }
 
 void dc_Room_draw(dc_Tilesets tilesets, dc_Room* const room) {
@@ -114,54 +77,99 @@ void dc_Room_draw(dc_Tilesets tilesets, dc_Room* const room) {
   static const unsigned int horiz_center = room_width / 2;
   static const unsigned int vert_center = room_height / 2;
 
-  Rectangle hori_wall_rect = (Rectangle){0, 7 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT};
-  Rectangle vert_wall_rect = (Rectangle){0, 7 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT};
-  Rectangle closed_door_rect = (Rectangle){2 * TILE_WIDTH, 7 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT};
-  Rectangle opened_door_rect = (Rectangle){1 * TILE_WIDTH, 7 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT};
+  Rectangle hori_wall_rect = DC_ATLAS_WALL;
+  Rectangle vert_wall_rect = DC_ATLAS_WALL;
+  Rectangle closed_door_rect = DC_ATLAS_DOOR_CLOSED;
+  Rectangle opened_door_rect = DC_ATLAS_DOOR_OPEN;
 
-  // TODO: remove magic numbers for vert_wall_rect, horiz_wall_rect, closed_door_rect, offset for drawing stuff
+  // TODO: remove magic numbers for offset for drawing stuff
 
   // north wall
   for(unsigned int i = 0; i < room_width; i++) {
-    if(i == horiz_center && room->door_north) {
-      if(room->doors_opened) DrawTexturePro(tilesets.zach, opened_door_rect, (Rectangle){TILE_WIDTH * 1.5 + TILE_WIDTH * i, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
-      else DrawTexturePro(tilesets.zach, closed_door_rect, (Rectangle){TILE_WIDTH * 1.5 + TILE_WIDTH * i, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+    if(i == horiz_center && (room->doors & DC_DOOR_NORTH)) {
+      if(room->doors_opened) dc_draw.texture(tilesets.atlas, opened_door_rect, (Rectangle){TILE_WIDTH * 1.5 + TILE_WIDTH * i, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+      else dc_draw.texture(tilesets.atlas, closed_door_rect, (Rectangle){TILE_WIDTH * 1.5 + TILE_WIDTH * i, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
     } else {
-      DrawTexturePro(tilesets.zach, hori_wall_rect, (Rectangle){TILE_WIDTH * 1.5 + TILE_WIDTH * i, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
+      dc_draw.texture(tilesets.atlas, hori_wall_rect, (Rectangle){TILE_WIDTH * 1.5 + TILE_WIDTH * i, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
     }
   }
 
   // south wall
   for(unsigned int i = 0; i < room_width+2; i++) {
-    if(i == horiz_center && room->door_south) {
-      if(room->doors_opened) DrawTexturePro(tilesets.zach, opened_door_rect, (Rectangle){TILE_WIDTH * 0.5 + TILE_WIDTH * i, TILE_HEIGHT * 6, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
-      else DrawTexturePro(tilesets.zach, closed_door_rect, (Rectangle){TILE_WIDTH * 0.5 + TILE_WIDTH * i, TILE_HEIGHT * 6, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+    if(i == horiz_center && (room->doors & DC_DOOR_SOUTH)) {
+      if(room->doors_opened) dc_draw.texture(tilesets.atlas, opened_door_rect, (Rectangle){TILE_WIDTH * 0.5 + TILE_WIDTH * i, TILE_HEIGHT * 6, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+      else dc_draw.texture(tilesets.atlas, closed_door_rect, (Rectangle){TILE_WIDTH * 0.5 + TILE_WIDTH * i, TILE_HEIGHT * 6, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
     } else {
-      DrawTexturePro(tilesets.zach, hori_wall_rect, (Rectangle){TILE_WIDTH * 0.5 + TILE_WIDTH * i, TILE_HEIGHT * 6, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
+      dc_draw.texture(tilesets.atlas, hori_wall_rect, (Rectangle){TILE_WIDTH * 0.5 + TILE_WIDTH * i, TILE_HEIGHT * 6, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
     }
   }
 
   // west wall
   for(unsigned int i = 0; i < room_height; i++) {
-    if(i == vert_center && room->door_west) {
-      if(room->doors_opened) DrawTexturePro(tilesets.zach, opened_door_rect, (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
-      else DrawTexturePro(tilesets.zach, closed_door_rect, (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+    if(i == vert_center && (room->doors & DC_DOOR_WEST)) {
+      if(room->doors_opened) dc_draw.texture(tilesets.atlas, opened_door_rect, (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+      else dc_draw.texture(tilesets.atlas, closed_door_rect, (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
     } else {
-      DrawTexturePro(tilesets.zach, vert_wall_rect, (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
+      dc_draw.texture(tilesets.atlas, vert_wall_rect, (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
     }
   }
 
   // east wall
   for(unsigned int i = 0; i < room_height; i++) {
-    if(i == vert_center && room->door_east) {
-      if(room->doors_opened) DrawTexturePro(tilesets.zach, opened_door_rect, (Rectangle){TILE_WIDTH * room_width + TILE_WIDTH * 1.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
-      else DrawTexturePro(tilesets.zach, closed_door_rect, (Rectangle){TILE_WIDTH * room_width + TILE_WIDTH * 1.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+    if(i == vert_center && (room->doors & DC_DOOR_EAST)) {
+      if(room->doors_opened) dc_draw.texture(tilesets.atlas, opened_door_rect, (Rectangle){TILE_WIDTH * room_width + TILE_WIDTH * 1.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
+      else dc_draw.texture(tilesets.atlas, closed_door_rect, (Rectangle){TILE_WIDTH * room_width + TILE_WIDTH * 1.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, WHITE);
     } else {
-      DrawTexturePro(tilesets.zach, vert_wall_rect, (Rectangle){TILE_WIDTH * room_width + TILE_WIDTH * 1.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
+      dc_draw.texture(tilesets.atlas, vert_wall_rect, (Rectangle){TILE_WIDTH * room_width + TILE_WIDTH * 1.5, TILE_HEIGHT * i + TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT}, (Vector2){0, 0}, 0.f, BRICKRED);
     }
   }
 }
 
+// the walls, doors and frame overlay only change when the doors open or we walk into another
+// room, so they get drawn once into their own render texture and blitted every frame. keyed on
+// where the room is and what it looks like, not a pointer: rooms move around inside the floor
+// table whenever it inserts, grows or evicts
+typedef struct {
+  RenderTexture2D target;
+  unsigned int room_x;
+  unsigned int room_y;
+  unsigned char doors;
+  bool doors_opened;
+  bool dirty;
+} dc_RoomLayer;
+
+dc_RoomLayer dc_RoomLayer_create(void) {
+  return (dc_RoomLayer){.target = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT), .dirty = true};
+}
+
+// what goes in the layer, on whichever target dc_draw's pointed at
+void dc_RoomLayer_contents(dc_Tilesets tilesets, dc_Room* const room) {
+  Rectangle f_rect = DC_ATLAS_FRAME;
+  dc_draw.clear(BLANK);
+  dc_Room_draw(tilesets, room);
+  dc_draw.texture(tilesets.atlas, f_rect, (Rectangle){0, 0, f_rect.width, f_rect.height}, (Vector2){0}, 0.f, WHITE);
+}
+
+// has to run outside of any other BeginTextureMode
+void dc_RoomLayer_update(dc_RoomLayer* layer, dc_Tilesets tilesets, unsigned int room_x, unsigned int room_y, dc_Room* const room) {
+  if(!layer->dirty && layer->room_x == room_x && layer->room_y == room_y && layer->doors == room->doors && layer->doors_opened == room->doors_opened) return;
+  BeginTextureMode(layer->target);
+    dc_RoomLayer_contents(tilesets, room);
+  EndTextureMode();
+  layer->room_x = room_x;
+  layer->room_y = room_y;
+  layer->doors = room->doors;
+  layer->doors_opened = room->doors_opened;
+  layer->dirty = false;
+}
+
+void dc_RoomLayer_draw(const dc_RoomLayer* layer) {
+  // render textures come out upside down
+  Rectangle source = {0, 0, layer->target.texture.width, -layer->target.texture.height};
+  Rectangle dest = {0, 0, layer->target.texture.width, layer->target.texture.height};
+  DrawTexturePro(layer->target.texture, source, dest, (Vector2){0}, 0.f, WHITE);
+}
+
 void dc_draw_player_health(dc_Tilesets tilesets, int hp, int hp_max) {
   unsigned int full_hearts = hp / 2;
   unsigned int half_hearts = hp % 2;
@@ -170,481 +178,760 @@ void dc_draw_player_health(dc_Tilesets tilesets, int hp, int hp_max) {
   // unsigned int empty_hearts = full_hearts + half_hearts - hp_max / 2;
   unsigned int empty_hearts = hp_max / 2 - half_hearts - full_hearts;
   for(int i = 0; i < full_hearts; i++) {
-    DrawTexturePro(tilesets.interface, (Rectangle){160, 120, 16, 24}, (Rectangle){15 + TILE_WIDTH*i, 15, 16, 24}, (Vector2){0, 0}, 0.f, WHITE);
-    DrawTexturePro(tilesets.interface, (Rectangle){176, 120, 16, 24}, (Rectangle){15 + TILE_WIDTH*i, 14, 16, 24}, (Vector2){0, 0}, 0.f, RED);
+    dc_draw.texture(tilesets.atlas, DC_ATLAS_HEART_EMPTY, (Rectangle){15 + TILE_WIDTH*i, 15, 16, 24}, (Vector2){0, 0}, 0.f, WHITE);
+    dc_draw.texture(tilesets.atlas, DC_ATLAS_HEART_FULL, (Rectangle){15 + TILE_WIDTH*i, 14, 16, 24}, (Vector2){0, 0}, 0.f, RED);
   }
   for(int i = 0; i < half_hearts; i++) {
-    DrawTexturePro(tilesets.interface, (Rectangle){144, 120, 16, 24}, (Rectangle){15 + TILE_WIDTH*i + full_hearts*TILE_WIDTH, 15, 16, 24}, (Vector2){0, 0}, 0.f, RED);
-    DrawTexturePro(tilesets.interface, (Rectangle){160, 120, 16, 24}, (Rectangle){15 + TILE_WIDTH*i + full_hearts*TILE_WIDTH, 15, 16, 24}, (Vector2){0, 0}, 0.f, WHITE);
+    dc_draw.texture(tilesets.atlas, DC_ATLAS_HEART_HALF, (Rectangle){15 + TILE_WIDTH*i + full_hearts*TILE_WIDTH, 15, 16, 24}, (Vector2){0, 0}, 0.f, RED);
+    dc_draw.texture(tilesets.atlas, DC_ATLAS_HEART_EMPTY, (Rectangle){15 + TILE_WIDTH*i + full_hearts*TILE_WIDTH, 15, 16, 24}, (Vector2){0, 0}, 0.f, WHITE);
   }
   for(int i = 0; i < empty_hearts; i++) {
-    DrawTexturePro(tilesets.interface, (Rectangle){160, 120, 16, 24}, (Rectangle){15 + TILE_WIDTH*i + full_hearts*TILE_WIDTH + half_hearts*TILE_WIDTH, 15, 16, 24}, (Vector2){0, 0}, 0.f, WHITE);
+    dc_draw.texture(tilesets.atlas, DC_ATLAS_HEART_EMPTY, (Rectangle){15 + TILE_WIDTH*i + full_hearts*TILE_WIDTH + half_hearts*TILE_WIDTH, 15, 16, 24}, (Vector2){0, 0}, 0.f, WHITE);
   }
 }
 
-//void dc_draw_player_targeting(dc_Tilesets tilesets, dc_Actor player, Camera2D cam) {
-void dc_draw_player_targeting(dc_Tilesets tilesets, dc_Actor* player) {
-  // Vector2 mouse_pos = GetWorldToScreen2D(GetMousePosition(), cam);
-  Vector2 mouse_pos = GetMousePosition();
-  Vector2 screen_scale = dc_get_screen_scaling_percent();
-  mouse_pos.x = mouse_pos.x * screen_scale.x;
-  mouse_pos.y = mouse_pos.y * screen_scale.y;
-  // Vector2 dir_to_mouse = dc_normalize_vector((Vector2){mouse_pos.x - player.position.x, mouse_pos.y - player.position.y});
-  double angle_to_mouse = atan2(mouse_pos.y - player->position.y, mouse_pos.x - player->position.x) * RAD2DEG + 135;
-  DrawTexturePro(tilesets.fx_general, (Rectangle){12 * TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT}, (Rectangle){player->position.x, player->position.y, TILE_WIDTH, TILE_HEIGHT}, (Vector2){15, 16}, angle_to_mouse, TBLUE);
-}
-
-void dc_ai_bat(dc_Actor* const self, dc_Actor* const player) {
-  if(player == NULL) return;
-  if(self->iframe_time_remaining > 0) return;
-  static const int BAT_SPEED = 50;
-
-  self->velocity = dc_get_direction_to(self->position, player->position);
-  self->velocity.x *= BAT_SPEED;
-  self->velocity.y *= BAT_SPEED;
-}
-
-void dc_Actor_update(dc_Actor* const actor_ptr, float dt) {
-  // update frames/anims
-  actor_ptr->time_until_next_frame -= dt;
-  if(actor_ptr->time_until_next_frame <= 0) {
-    if(actor_ptr->current_frame+1 >= actor_ptr->frame_count) {
-      actor_ptr->current_frame = 0;
-      if(actor_ptr->free_on_anim_comp) actor_ptr->should_be_freed = true;
-    } else {
-      actor_ptr->current_frame++;
-    }
-    actor_ptr->time_until_next_frame += actor_ptr->time_per_frame;
-  }
-
-  if(actor_ptr->iframe_time_remaining > 0) actor_ptr->iframe_time_remaining -= dt;
-
-  // update position based on velocity
-  actor_ptr->position.x += actor_ptr->velocity.x * dt;
-  actor_ptr->position.y += actor_ptr->velocity.y * dt;
-}
-
-void dc_Actor_draw(dc_Actor* actor) {
-  if(actor->has_shadow) DrawEllipse(actor->position.x + actor->shadow_offset.x, actor->position.y + actor->shadow_offset.y, TILE_WIDTH / 2.f, 2, GRAY);
-  Rectangle dest = {actor->position.x, actor->position.y, TILE_WIDTH, TILE_HEIGHT};
-  Color c = actor->iframe_time_remaining > 0 ? (Color){255u * sin(GetTime() * IFRAME_FLASH_SPEED), 255u * sin(GetTime() * IFRAME_FLASH_SPEED), 255u * sin(GetTime() * IFRAME_FLASH_SPEED), 255u} : actor->color;
-  DrawTexturePro(actor->textures[actor->current_frame], actor->sources[actor->current_frame], dest, actor->origin, actor->rotation, c);
-}
-
-dc_Actor* dc_Actor_create_bat(dc_Frames* frame_data, Vector2 pos) {
-  dc_Actor* bat = malloc(sizeof(dc_Actor));
-  bat->textures = frame_data->dwarf_textures;
-  bat->sources = frame_data->dwarf_rects;
-  bat->color = WHITE;
-  bat->rotation = 0.f;
-  bat->position = pos;
-  bat->velocity = (Vector2){0};
-  bat->origin = (Vector2){11, 17};
-  bat->time_per_frame = 0.5f;
-  bat->time_until_next_frame = 0.5f;
-  bat->current_frame = 0;
-  bat->has_shadow = true;
-  bat->shadow_offset = (Vector2){0, TILE_HEIGHT * 0.3};
-  bat->frame_count = frame_data->dwarf_frames;
-  bat->free_on_anim_comp = false;
-  bat->should_be_freed = false;
-  bat->collision_layer = COL_LAYER_ENEMY;
-  bat->collision_mask = COL_LAYER_PLAYER;
-  bat->collision_damage = 1;
-  bat->iframe_time_remaining = 0;
-  bat->hp = 3;
-  bat->hp_max = 3;
-  bat->ai = dc_ai_bat;
-
-  return bat;
-}
-
-dc_Actor* dc_Actor_create_player(dc_Frames* frame_data) {
-  dc_Actor* player = malloc(sizeof(dc_Actor));
-  player->textures = frame_data->skeleton_textures;
-  player->sources = frame_data->skeleton_rects;
-  player->color = WHITE;
-  player->rotation = 0.f;
-  player->position = (Vector2){100, 100};
-  player->origin = (Vector2){10, 13};
-  player->velocity = (Vector2){0};
-  player->time_per_frame = 0.5f;
-  player->time_until_next_frame = 0.5f;
-  player->current_frame = 0;
-  player->has_shadow = true;
-  player->shadow_offset = (Vector2){1, TILE_HEIGHT * 0.475};
-  player->frame_count = frame_data->skeleton_frames;
-  player->free_on_anim_comp = false;
-  player->should_be_freed = false;
-  player->collision_layer = COL_LAYER_PLAYER;
-  player->collision_mask = 0;
-  player->collision_damage = 0;
-  player->iframe_time_remaining = 0;
-  player->hp = 6;
-  player->hp_max = 6;
-  player->ai = NULL;
-
-  return player;
-}
-
-dc_Actor* dc_Actor_create_player_slice(dc_Frames* frame_data, Vector2 pos, float rot) {
-  dc_Actor* slice = malloc(sizeof(dc_Actor));
-  slice->textures = frame_data->slice_textures;
-  slice->sources = frame_data->slice_rects;
-  slice->color = WHITE;
-  slice->rotation = rot;
-  // slice->position = (Vector2){pos.x - 16 * cos(rot * DEG2RAD), pos.y - 16 * sin(rot * DEG2RAD)};
-  slice->position = pos;
-  //slice->position.x -= 16 * cos(rot * DEG2RAD);
-  //slice->position.y -= 16 * sin(rot * DEG2RAD);
-  // slice->origin = (Vector2){15, 16};
-  // slice->origin = (Vector2){TILE_WIDTH/2, TILE_HEIGHT/2};
-  slice->origin = (Vector2){TILE_WIDTH/2, TILE_HEIGHT/2};
-  slice->velocity = (Vector2){0};
-  slice->time_per_frame = 0.1f;
-  slice->time_until_next_frame = 0.1f;
-  slice->current_frame = 0;
-  slice->has_shadow = false;
-  // slice->shadow_offset = (Vector2){0, TILE_HEIGHT * 0.3};
-  slice->frame_count = frame_data->slice_frames;
-  slice->free_on_anim_comp = true;
-  slice->should_be_freed = false;
-  slice->collision_layer = 0;
-  slice->collision_mask = COL_LAYER_ENEMY;
-  slice->collision_damage = 1;
-  slice->iframe_time_remaining = 0;
-  slice->hp = 1; // not like it matters; this has no layer so it can't be hit!
-  slice->hp_max = 1;
-  slice->ai = NULL;
-
-  return slice;
-}
-
-void dc_Actor_handle_collisions(dc_Actor** actors) { // const?
-  for(int us_idx = 0; us_idx < MAX_ACTORS; us_idx++) {
-    for(int them_idx = 0; them_idx < MAX_ACTORS; them_idx++) {
-      dc_Actor* us = actors[us_idx];
-      dc_Actor* them = actors[them_idx];
-      // if(us == NULL || them == NULL || us->iframe_time_remaining > 0 || them->iframe_time_remaining > 0) continue;
-      if(us == NULL || them == NULL) continue;
-      if(us == them) continue;
-      if(us->iframe_time_remaining > 0 || them->iframe_time_remaining > 0) continue;
-      if(!CheckCollisionCircles(us->position, TILE_WIDTH/2.f, them->position, TILE_WIDTH/2.f)) continue;
-      if(us->collision_mask & them->collision_layer) {
-        them->hp -= us->collision_damage;
-        Vector2 v = dc_get_direction_to(us->position, them->position);
-        v.x *= 20;
-        v.y *= 20;
-        them->velocity = v;
-        if(them->hp <= 0) {
-          them->should_be_freed = true;
-        } else them->iframe_time_remaining = IFRAME_DURATION;
-      }
-    }
+// aim is in virtual screen space, like dc_Input's
+void dc_draw_player_targeting(dc_Tilesets tilesets, Vector2 player_position, Vector2 aim) {
+  double angle_to_mouse = atan2(aim.y - player_position.y, aim.x - player_position.x) * RAD2DEG + 135;
+  dc_draw.texture(tilesets.atlas, DC_ATLAS_SLICE_0, (Rectangle){player_position.x, player_position.y, TILE_WIDTH, TILE_HEIGHT}, (Vector2){15, 16}, angle_to_mouse, TBLUE);
+}
+
+// hearts and the remaining/game over text only change a few times a room, so they live in a
+// render texture that's only redrawn when what they show changes
+typedef struct {
+  RenderTexture2D target;
+  bool valid;
+  bool alive;
+  int hp;
+  int hp_max;
+  unsigned int remaining;
+  unsigned long rebuilds;
+  unsigned int rebuilds_this_frame;
+} dc_Hud;
+
+dc_Hud dc_Hud_create(void) {
+  return (dc_Hud){.target = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT)};
+}
+
+void dc_Hud_contents(dc_Tilesets tilesets, Font font, bool alive, int hp, int hp_max, unsigned int remaining) {
+  dc_draw.clear(BLANK);
+  if(alive) {
+    dc_draw_player_health(tilesets, hp, hp_max);
+    dc_draw.text(font, TextFormat("Remaining: %d", remaining), (Vector2){100, 20}, 16.f, 0.1f, WHITE);
+  } else {
+    dc_draw.text(font, "Game Over!", (Vector2){100, 20}, 16.f, 0.1f, WHITE);
   }
 }
 
-Vector2 dc_get_player_input_vector(void) {
-  Vector2 p_input_vec = (Vector2){0};
-  if(IsKeyDown(KEY_A)) {
-    p_input_vec.x -= 1;
+// has to run outside of any other BeginTextureMode
+void dc_Hud_update(dc_Hud* hud, dc_Tilesets tilesets, Font font, bool alive, int hp, int hp_max, unsigned int remaining) {
+  hud->rebuilds_this_frame = 0;
+  if(hud->valid && hud->alive == alive && (!alive || (hud->hp == hp && hud->hp_max == hp_max && hud->remaining == remaining))) return;
+  BeginTextureMode(hud->target);
+    dc_Hud_contents(tilesets, font, alive, hp, hp_max, remaining);
+  EndTextureMode();
+  hud->valid = true;
+  hud->alive = alive;
+  hud->hp = hp;
+  hud->hp_max = hp_max;
+  hud->remaining = remaining;
+  hud->rebuilds++;
+  hud->rebuilds_this_frame = 1;
+}
+
+void dc_Hud_draw(const dc_Hud* hud) {
+  // drawing into the texture already multiplied the colours by their alpha, so blending it back
+  // out as premultiplied keeps the antialiased edges of the text from going dark
+  Rectangle source = {0, 0, hud->target.texture.width, -hud->target.texture.height};
+  Rectangle dest = {0, 0, hud->target.texture.width, hud->target.texture.height};
+  BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+  DrawTexturePro(hud->target.texture, source, dest, (Vector2){0}, 0.f, WHITE);
+  EndBlendMode();
+}
+
+// where every actor was before the last sim step, by handle slot, so a frame that lands between
+// two steps can draw everyone part of the way along instead of snapping along at SIM_HZ
+typedef struct {
+  Vector2* position;
+  unsigned int* generation; // which occupant of the slot it was, 0 when there's nothing to blend from
+  unsigned int capacity;
+} dc_Interp;
+
+void dc_Interp_capture(dc_Interp* interp, const dc_Actors* actors) {
+  if(interp->capacity < actors->capacity) {
+    interp->position = realloc(interp->position, sizeof(Vector2) * actors->capacity);
+    interp->generation = realloc(interp->generation, sizeof(unsigned int) * actors->capacity);
+    memset(interp->generation + interp->capacity, 0, sizeof(unsigned int) * (actors->capacity - interp->capacity));
+    interp->capacity = actors->capacity;
   }
-  if(IsKeyDown(KEY_D)) {
-    p_input_vec.x += 1;
+  for(unsigned int a = 0; a < actors->count; a++) {
+    unsigned int slot = actors->slot_of[a];
+    interp->position[slot] = actors->position[a];
+    interp->generation[slot] = actors->slots[slot].generation;
   }
-  if(IsKeyDown(KEY_W)) {
-    p_input_vec.y -= 1;
+}
+
+// for jumps that shouldn't be smoothed over: walking into a room, rewinding, loading
+void dc_Interp_reset(dc_Interp* interp) {
+  if(interp->capacity) memset(interp->generation, 0, sizeof(unsigned int) * interp->capacity);
+}
+
+void dc_Interp_free(dc_Interp* interp) {
+  free(interp->position);
+  free(interp->generation);
+  *interp = (dc_Interp){0};
+}
+
+// alpha is 0 at the state before the last step and 1 at the current one. anything that didn't
+// exist before the step just gets drawn where it is
+Vector2 dc_Interp_position(const dc_Interp* interp, const dc_Actors* actors, unsigned int a, float alpha) {
+  unsigned int slot = actors->slot_of[a];
+  Vector2 now = actors->position[a];
+  if(slot >= interp->capacity || interp->generation[slot] != actors->slots[slot].generation) return now;
+  Vector2 before = interp->position[slot];
+  return (Vector2){before.x + (now.x - before.x) * alpha, before.y + (now.y - before.y) * alpha};
+}
+
+// what everyone in iframes gets tinted this frame, time is in seconds
+Color dc_iframe_flash(double time) {
+  unsigned char level = 255u * sin(time * IFRAME_FLASH_SPEED);
+  return (Color){level, level, level, 255u};
+}
+
+void dc_Actor_draw_shadow(const dc_Actors* actors, unsigned int a, Vector2 position) {
+  const dc_Sprite* sprite = &actors->sprite[a];
+  dc_draw.ellipse(position.x + sprite->shadow_offset.x, position.y + sprite->shadow_offset.y, TILE_WIDTH / 2.f, 2, GRAY);
+}
+
+void dc_Actor_draw(const dc_Frames* frame_data, const dc_Actors* actors, unsigned int a, Vector2 position, Color flash) {
+  const dc_Sprite* sprite = &actors->sprite[a];
+  unsigned int frame = actors->anim[a].current_frame;
+  Rectangle dest = {position.x, position.y, TILE_WIDTH, TILE_HEIGHT};
+  Color c = actors->iframe_time_remaining[a] > 0 ? flash : sprite->color;
+  dc_draw.texture(frame_data->textures[sprite->frames][frame], frame_data->rects[sprite->frames][frame], dest, sprite->origin, sprite->rotation, c);
+}
+
+// shadows are on the floor under everyone, so they all go down first in one run of ellipses,
+// then the sprites back to front
+void dc_DrawList_draw(const dc_DrawList* list, const dc_Frames* frame_data, const dc_Actors* actors, Color flash) {
+  for(unsigned int i = 0; i < list->count; i++) {
+    if(actors->sprite[list->actors[i]].has_shadow) dc_Actor_draw_shadow(actors, list->actors[i], list->positions[i]);
   }
-  if(IsKeyDown(KEY_S)) {
-    p_input_vec.y += 1;
+  for(unsigned int i = 0; i < list->count; i++) {
+    dc_Actor_draw(frame_data, actors, list->actors[i], list->positions[i], flash);
   }
-  return dc_get_vector_length(p_input_vec) == 0 ? (Vector2){0} : dc_normalize_vector(p_input_vec);
 }
 
-void dc_Room_generate(dc_Room** rooms, unsigned int old_room_x, unsigned int old_room_y, unsigned int new_room_x, unsigned int new_room_y, unsigned int rooms_cleared) {
-  unsigned int old_room_idx = old_room_x + old_room_x * FLOOR_WIDTH;
-  unsigned int new_room_idx = new_room_x + new_room_y * FLOOR_WIDTH;
+// over the top of everyone, they're slashes and sparks
+void dc_Effects_draw(const dc_Effects* effects, const dc_Frames* frame_data) {
+  for(unsigned int i = 0; i < effects->count; i++) {
+    const dc_Effect* e = dc_Effects_at_const(effects, i);
+    const dc_EffectInfo* info = &dc_effect_info[e->kind];
+    Rectangle dest = {e->position.x, e->position.y, TILE_WIDTH, TILE_HEIGHT};
+    dc_draw.texture(frame_data->textures[info->frames][e->frame], frame_data->rects[info->frames][e->frame], dest, info->origin, e->rotation, WHITE);
+  }
+}
+
+// everything the window build reads off the keyboard and mouse, one bit each in the input queue.
+// the movement ones line up with DC_KEY_*
+typedef enum {
+  CONTROL_UP,
+  CONTROL_LEFT,
+  CONTROL_DOWN,
+  CONTROL_RIGHT,
+  CONTROL_SLICE,
+  CONTROL_REWIND,
+  CONTROL_HUD_STATS,
+  CONTROL_PROFILER,
+  CONTROL_TRACE,
+  CONTROL_QUICKSAVE,
+  CONTROL_QUICKLOAD,
+  CONTROL_COUNT
+} dc_Control;
+
+#define CONTROL_BIT(c) (1u << (c))
+#define CONTROL_MOVE_MASK (CONTROL_BIT(CONTROL_UP) | CONTROL_BIT(CONTROL_LEFT) | CONTROL_BIT(CONTROL_DOWN) | CONTROL_BIT(CONTROL_RIGHT))
+
+static const int dc_control_keys[CONTROL_COUNT] = {
+  [CONTROL_UP] = KEY_W,
+  [CONTROL_LEFT] = KEY_A,
+  [CONTROL_DOWN] = KEY_S,
+  [CONTROL_RIGHT] = KEY_D,
+  [CONTROL_SLICE] = -1, // the left mouse button
+  [CONTROL_REWIND] = KEY_R,
+  [CONTROL_HUD_STATS] = KEY_F3,
+  [CONTROL_PROFILER] = KEY_F2,
+  [CONTROL_TRACE] = KEY_F9,
+  [CONTROL_QUICKSAVE] = KEY_F5,
+  [CONTROL_QUICKLOAD] = KEY_F6
+};
+
+// the one place the keyboard and mouse get read. it only sees what raylib's last
+// PollInputEvents saw, so calling PollInputEvents first gets something fresher
+void dc_poll_input(dc_InputQueue* queue) {
+  uint32_t down = 0;
+  for(int c = 0; c < CONTROL_COUNT; c++) {
+    bool is_down = dc_control_keys[c] < 0 ? IsMouseButtonDown(MOUSE_LEFT_BUTTON) : IsKeyDown(dc_control_keys[c]);
+    if(is_down) down |= CONTROL_BIT(c);
+  }
+  dc_InputQueue_sample(queue, dc_time_now(), down, dc_get_virtual_mouse());
+}
 
-  if(rooms[new_room_idx] != NULL) return; // room already exists
-  
-  rooms[new_room_idx] = malloc(sizeof(dc_Room));
-  *rooms[new_room_idx] = (dc_Room){0};
+// one step's worth of the queue, squashed down to what goes in the input log. a key that was
+// tapped and let go inside the step still counts as held for it
+dc_InputRecord dc_InputStep_record(dc_InputStep step, float dt) {
+  uint8_t keys = (step.held | step.pressed) & CONTROL_MOVE_MASK;
+  uint8_t buttons = step.pressed & CONTROL_BIT(CONTROL_SLICE) ? DC_BUTTON_SLICE : 0;
+  return dc_InputRecord_create(keys, buttons, step.aim, dt);
+}
 
-  // guarantee a door based on our last room
-  if(old_room_x < new_room_x) {
-    rooms[new_room_idx]->door_west = true;
-  } else if(old_room_x > new_room_x) {
-    rooms[new_room_idx]->door_east = true;
-  } else if(old_room_y < new_room_y) {
-    rooms[new_room_idx]->door_north = true;
-  } else if(old_room_y > new_room_y) {
-    rooms[new_room_idx]->door_south = true;
+// a replay runs on the kernels it was recorded with or not at all. they're all meant to give the
+// same bits, the checks in the log are what prove it
+bool dc_open_replay(dc_InputLog* log, const char* path) {
+  if(!dc_InputLog_open(log, path)) return false;
+  if(strcmp(log->kernels, dc_kernels.name) != 0 && !dc_kernels_select(log->kernels)) {
+    fprintf(stderr, "%s was recorded with %s kernels, which can't run here\n", path, log->kernels);
+    dc_InputLog_close(log);
+    return false;
   }
+  return true;
+}
 
-  /*
-  if(!rooms[new_room_idx]->door_west && new_room_x-1 > 0) {
-    // rooms[new_room_idx]->door_west = rand() % 2 == 0;
-    rooms[new_room_idx]->door_west = true;
-  } else if(!rooms[new_room_idx]->door_east && new_room_x+1 < FLOOR_WIDTH) {
-    // rooms[new_room_idx]->door_east = rand() % 2 == 0;
-    rooms[new_room_idx]->door_east = true;
-  } else if(!rooms[new_room_idx]->door_south && new_room_y+1 < FLOOR_HEIGHT) {
-    // rooms[new_room_idx]->door_south = rand() % 2 == 0;
-    rooms[new_room_idx]->door_south = true;
-  } else if(!rooms[new_room_idx]->door_south && new_room_y-1 > 0) {
-    // rooms[new_room_idx]->door_north = rand() % 2 == 0;
-    rooms[new_room_idx]->door_north = true;
-  }*/
+// false, and says where, if the world isn't where the recording says it got to
+bool dc_replay_check(const dc_InputLog* log, const dc_World* world) {
+  unsigned long long hash = dc_World_hash(world);
+  if(hash == log->check) return true;
+  fprintf(stderr, "replay drifted by step %lu: state %016llx, recorded %016llx\n", log->check_steps, hash, log->check);
+  return false;
+}
 
-  if(new_room_x != 0) {
-    // rooms[new_room_idx]->door_west = rand() % 2 == 0;
-    rooms[new_room_idx]->door_west = true;
+// spreads bats over a grid across the floor of the room, same spots every time
+static void dc_spawn_swarm(dc_Frames* frame_data, dc_Actors* actors, unsigned int count) {
+  for(unsigned int b = 0; b < count; b++) {
+    Vector2 pos = {TILE_WIDTH * 2 + (b % 97) * (TILE_WIDTH * 16 / 97.f), TILE_HEIGHT * 2.8 + (b / 97 % 23) * (TILE_HEIGHT * 2.8 / 23.f)};
+    dc_Actors_add(actors, dc_Actor_create_bat(frame_data, pos));
   }
-  if(new_room_x != FLOOR_WIDTH - 1) {
-    // rooms[new_room_idx]->door_east = rand() % 2 == 0;
-    rooms[new_room_idx]->door_east = true;
+}
+
+#ifdef DC_PROFILE
+// p50/p95/p99 of every phase over the last DC_PROF_FRAMES frames
+void dc_draw_profiler(void) {
+  DrawRectangle(0, 0, 150, 12 + 9 * (DC_PHASE_COUNT + 1), (Color){0, 0, 0, 200});
+  float p50, p95, p99;
+  dc_prof_frame_percentile(50, &p50);
+  dc_prof_frame_percentile(95, &p95);
+  dc_prof_frame_percentile(99, &p99);
+  DrawText("ms       p50   p95   p99", 2, 2, 8, WHITE);
+  DrawText(TextFormat("frame   %5.2f %5.2f %5.2f", p50, p95, p99), 2, 11, 8, YELLOW);
+  for(int p = 0; p < DC_PHASE_COUNT; p++) {
+    dc_prof_percentile(p, 50, &p50);
+    dc_prof_percentile(p, 95, &p95);
+    dc_prof_percentile(p, 99, &p99);
+    DrawText(TextFormat("%-7.7s %5.2f %5.2f %5.2f", dc_prof_phase_name(p), p50, p95, p99), 2, 20 + 9 * p, 8, WHITE);
   }
-  if(new_room_y != FLOOR_HEIGHT - 1) {
-    // rooms[new_room_idx]->door_south = rand() % 2 == 0;
-    rooms[new_room_idx]->door_south = true;
+}
+
+void dc_print_profile(void) {
+  float p50, p95, p99;
+  unsigned int frames = dc_prof_frame_percentile(50, &p50);
+  printf("profile over the last %u steps (us)    p50      p95      p99\n", frames);
+  for(int p = 0; p < DC_PHASE_COUNT; p++) {
+    dc_prof_percentile(p, 50, &p50);
+    dc_prof_percentile(p, 95, &p95);
+    dc_prof_percentile(p, 99, &p99);
+    if(p99 > 0) printf("  %-32s %8.2f %8.2f %8.2f\n", dc_prof_phase_name(p), p50 * 1000, p95 * 1000, p99 * 1000);
   }
-  if(new_room_y != 0) {
-    // rooms[new_room_idx]->door_north = rand() % 2 == 0;
-    rooms[new_room_idx]->door_north = true;
+}
+#endif
+
+// runs the sim as fast as it'll go with no window, gpu, font or audio device.
+// the textures in frame_data are all zeroed out, which is fine since nothing draws them
+// swarm piles extra bats into every new world so the threaded passes have enough actors to split up
+int dc_run_headless(unsigned long steps, unsigned int swarm, unsigned long long seed, const char* trace_path) {
+  dc_Frames frame_data = dc_Frames_create((dc_Tilesets){0});
+  dc_World world;
+  dc_World_init(&world, &frame_data, seed);
+  dc_spawn_swarm(&frame_data, &world.actors, swarm);
+
+  static const float dt = SIM_DT;
+  unsigned long resets = 0;
+  unsigned long rooms_entered = 0;
+  double start = dc_time_now();
+  for(unsigned long step = 0; step < steps; step++) {
+    dc_sim_step(&world, dc_sim_scripted_input(&world, step), dt);
+    DC_PROF_FRAME();
+    if(world.events & DC_EVENT_ROOM_CHANGED) rooms_entered++;
+    if(dc_World_player(&world) < 0 || world.rooms_cleared >= ROOMS_TO_WIN) {
+      dc_World_free(&world);
+      resets++;
+      dc_World_init(&world, &frame_data, seed + resets);
+      dc_spawn_swarm(&frame_data, &world.actors, swarm);
+    }
   }
+  double elapsed = dc_time_now() - start;
+
+  printf("headless (%s kernels, %u threads): %lu steps in %.3fs (%.0f steps/s), %lu rooms entered, %lu resets, state %016llx\n", dc_kernels.name, dc_jobs_worker_count(), steps, elapsed, elapsed > 0 ? steps / elapsed : 0, rooms_entered, resets, dc_World_hash(&world));
+#ifdef DC_PROFILE
+  dc_print_profile();
+  if(trace_path && !dc_prof_write_trace(trace_path)) fprintf(stderr, "couldn't write %s\n", trace_path);
+#endif
+  dc_World_free(&world);
+  return 0;
+}
 
-  printf("%d, %d\n", new_room_x, new_room_y);
-
-  if(rooms_cleared < ROOMS_TO_WIN) rooms[new_room_idx]->remaining_monsters = 1 + rand() % 4;
-  else {
-    rooms[new_room_idx]->remaining_monsters = 0;
+// re-runs a recorded session as fast as it'll go, for profiling whatever went wrong in it
+int dc_run_replay(const char* path, const char* trace_path) {
+  dc_InputLog log;
+  if(!dc_open_replay(&log, path)) return 1;
+  dc_Frames frame_data = dc_Frames_create((dc_Tilesets){0});
+  dc_World world;
+  dc_World_init(&world, &frame_data, log.seed);
+
+  unsigned long rooms_entered = 0;
+  unsigned long checks = 0;
+  bool drifted = false;
+  dc_InputRecord record;
+  dc_InputLogEntry entry;
+  double start = dc_time_now();
+  while(!drifted && (entry = dc_InputLog_read(&log, &record)) != DC_INPUT_LOG_END) {
+    if(entry == DC_INPUT_LOG_CHECK) {
+      drifted = !dc_replay_check(&log, &world);
+      checks++;
+      continue;
+    }
+    dc_sim_step(&world, dc_InputRecord_input(record), record.dt);
+    DC_PROF_FRAME();
+    if(world.events & DC_EVENT_ROOM_CHANGED) rooms_entered++;
   }
+  double elapsed = dc_time_now() - start;
+
+  printf("replay (%s kernels, %u threads): %lu steps in %.3fs (%.0f steps/s), %lu rooms entered, state %016llx, %lu checks %s\n", dc_kernels.name, dc_jobs_worker_count(), log.steps, elapsed, elapsed > 0 ? log.steps / elapsed : 0, rooms_entered, dc_World_hash(&world), checks, drifted ? "failed" : "passed");
+#ifdef DC_PROFILE
+  dc_print_profile();
+  if(trace_path && !dc_prof_write_trace(trace_path)) fprintf(stderr, "couldn't write %s\n", trace_path);
+#endif
+  dc_InputLog_close(&log);
+  dc_World_free(&world);
+  if(checks == 0) fprintf(stderr, "%s has no checks in it, it got cut off before the end\n", path);
+  return drifted || checks == 0 ? 1 : 0;
 }
 
-void dc_spawn_actor(dc_Frames* frame_data, dc_Actor** actors, unsigned int new_fella_count) {
-  Vector2 spawn_points[] = {(Vector2){50, 50}, (Vector2){250, 50}, (Vector2){50, 250}, (Vector2){250, 250}};
+// draws what the window build would after every step of the scripted walk (minus the debug
+// overlays and the scale up to the window), only on the cpu, and times it. no window or gpu, so
+// it runs on any box. out_path gets the last frame as a png; golden_path is one written that way
+// earlier, and any pixel that's changed since makes it fail. no_text leaves the text out, its
+// glyphs are whatever the raylib build's font rasterizer made of the ttf, so they're no good
+// for comparing frames from different machines
+int dc_run_cpu_render(unsigned long steps, unsigned int swarm, unsigned long long seed, const char* pack_path, bool no_text, const char* out_path, const char* golden_path) {
+  dc_Pack pack;
+  if(!dc_open_assets(&pack, pack_path)) return 1;
+  dc_AssetLoad assets[ASSET_COUNT];
+  memcpy(assets, dc_game_assets, sizeof(assets));
+  dc_assets_decode(&pack, assets, ASSET_COUNT, true);
+  ImageFormat(&assets[ASSET_ATLAS].image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+  ImageFormat(&assets[ASSET_FONT].image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+  // the layers the window build keeps in render textures
+  Image room_layer = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLANK);
+  Image hud_layer = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLANK);
+  Image frame = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLACK);
+  Texture2D room_texture = dc_draw_cpu_texture(&room_layer);
+  Texture2D hud_texture = dc_draw_cpu_texture(&hud_layer);
+  Rectangle screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+  dc_Tilesets tilesets = {.atlas = dc_draw_cpu_texture(&assets[ASSET_ATLAS].image)};
+  Font font = no_text ? (Font){0} : (Font){
+    .baseSize = assets[ASSET_FONT].font_size,
+    .glyphCount = assets[ASSET_FONT].glyph_count,
+    .glyphPadding = FONT_GLYPH_PADDING,
+    .texture = dc_draw_cpu_texture(&assets[ASSET_FONT].image),
+    .recs = assets[ASSET_FONT].glyph_recs,
+    .glyphs = assets[ASSET_FONT].glyphs
+  };
+  dc_Frames frame_data = dc_Frames_create(tilesets);
+  dc_World world;
+  dc_World_init(&world, &frame_data, seed);
+  dc_spawn_swarm(&frame_data, &world.actors, swarm);
+
+  dc_DrawList draw_list = {0};
+  unsigned long resets = 0;
+  bool room_dirty = true;
+  double elapsed = 0, worst = 0;
+  for(unsigned long step = 0; step < steps; step++) {
+    dc_Input input = dc_sim_scripted_input(&world, step);
+    dc_sim_step(&world, input, SIM_DT);
+    if(world.events & (DC_EVENT_DOORS_OPENED | DC_EVENT_ROOM_CHANGED)) room_dirty = true;
+    if(dc_World_player(&world) < 0 || world.rooms_cleared >= ROOMS_TO_WIN) {
+      dc_World_free(&world);
+      resets++;
+      dc_World_init(&world, &frame_data, seed + resets);
+      dc_spawn_swarm(&frame_data, &world.actors, swarm);
+      room_dirty = true;
+    }
+
+    double start = dc_time_now();
+    dc_Room* room = dc_World_room(&world);
+    int player = dc_World_player(&world);
+    if(room_dirty) {
+      dc_draw_cpu(&room_layer);
+      dc_RoomLayer_contents(tilesets, room);
+      room_dirty = false;
+    }
+    dc_draw_cpu(&hud_layer);
+    if(player >= 0) dc_Hud_contents(tilesets, font, true, world.actors.health[player].hp, world.actors.health[player].hp_max, room->remaining_monsters);
+    else dc_Hud_contents(tilesets, font, false, 0, 0, 0);
+
+    dc_draw_cpu(&frame);
+    dc_draw.clear(BLACK);
+    if(world.rooms_cleared >= ROOMS_TO_WIN) {
+      dc_draw.text(font, DC_WIN_TEXT, (Vector2){20, 20}, 16.f, 0.1f, WHITE);
+    } else {
+      dc_draw.texture(room_texture, screen, screen, (Vector2){0}, 0.f, WHITE);
+      dc_DrawList_clear(&draw_list);
+      for(unsigned int a = 0; a < world.actors.count; a++) dc_DrawList_add(&draw_list, &world.actors, a, world.actors.position[a]);
+      dc_DrawList_sort(&draw_list);
+      dc_DrawList_draw(&draw_list, &frame_data, &world.actors, dc_iframe_flash(step * SIM_DT));
+      dc_Effects_draw(&world.effects, &frame_data);
+      dc_draw.blend(BLEND_ALPHA_PREMULTIPLY);
+      dc_draw.texture(hud_texture, screen, screen, (Vector2){0}, 0.f, WHITE);
+      dc_draw.blend(BLEND_ALPHA);
+      if(player >= 0) dc_draw_player_targeting(tilesets, world.actors.position[player], input.aim);
+    }
+    double frame_time = dc_time_now() - start;
+    elapsed += frame_time;
+    if(frame_time > worst) worst = frame_time;
+  }
+  dc_draw_gpu();
+  printf("cpu render (%u threads): %lu frames, %.4fms a frame on average, %.4fms worst, %lu resets, state %016llx\n", dc_jobs_worker_count(), steps, steps ? elapsed * 1000 / steps : 0, worst * 1000, resets, dc_World_hash(&world));
+
+  int result = 0;
+  if(out_path && !ExportImage(frame, out_path)) {
+    fprintf(stderr, "can't write %s\n", out_path);
+    result = 1;
+  }
+  if(golden_path) {
+    Image golden = LoadImage(golden_path);
+    if(golden.data == NULL || golden.width != frame.width || golden.height != frame.height) {
+      fprintf(stderr, "%s isn't a %dx%d image\n", golden_path, frame.width, frame.height);
+      result = 1;
+    } else {
+      ImageFormat(&golden, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+      unsigned long changed = 0;
+      for(int p = 0; p < frame.width * frame.height; p++) {
+        if(memcmp((unsigned char*)frame.data + p * 4, (unsigned char*)golden.data + p * 4, 4) != 0) changed++;
+      }
+      printf("golden %s: %lu pixels differ\n", golden_path, changed);
+      if(changed) result = 1;
+    }
+    UnloadImage(golden);
+  }
+
+  dc_DrawList_free(&draw_list);
+  dc_World_free(&world);
+  UnloadImage(frame);
+  UnloadImage(hud_layer);
+  UnloadImage(room_layer);
+  for(unsigned int a = 0; a < ASSET_COUNT; a++) dc_AssetLoad_free(&assets[a]);
+  dc_Pack_close(&pack);
+  return result;
+}
 
-  for(int e = 0; e < new_fella_count; e++) {
-    for(int a = 0; a < MAX_ACTORS; a++) {
-      if(actors[a] != NULL) continue;
-      actors[a] = dc_Actor_create_bat(frame_data, spawn_points[e]);
-      break;
+// decodes everything the game loads at startup, first one after another and then spread over
+// the job system, and reports the best of a few rounds of each. no window or gpu involved
+int dc_run_startup_bench(const char* pack_path) {
+  dc_Pack pack;
+  if(!dc_open_assets(&pack, pack_path)) return 1;
+  static const unsigned int rounds = 5;
+  double best[2] = {1e9, 1e9};
+  double asset_time[ASSET_COUNT] = {0};
+  for(unsigned int r = 0; r < rounds; r++) {
+    for(int parallel = 0; parallel < 2; parallel++) {
+      dc_AssetLoad loads[ASSET_COUNT];
+      memcpy(loads, dc_game_assets, sizeof(loads));
+      double start = dc_time_now();
+      dc_assets_decode(&pack, loads, ASSET_COUNT, parallel);
+      double elapsed = dc_time_now() - start;
+      if(elapsed < best[parallel]) best[parallel] = elapsed;
+      for(unsigned int a = 0; a < ASSET_COUNT; a++) {
+        if(!parallel) asset_time[a] += loads[a].decode_time / rounds;
+        dc_AssetLoad_free(&loads[a]);
+      }
     }
   }
+  for(unsigned int a = 0; a < ASSET_COUNT; a++) {
+    printf("startup bench: %-30s %7.2fms\n", dc_game_assets[a].name, asset_time[a] * 1000);
+  }
+  printf("startup bench: serial %.2fms, parallel (%u threads) %.2fms, %.2fx\n", best[0] * 1000, dc_jobs_worker_count(), best[1] * 1000, best[1] > 0 ? best[0] / best[1] : 0);
+  dc_Pack_close(&pack);
+  return 0;
 }
 
 int main(int argc, char** argv) {
-  // srand(time(NULL));
-  InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "REVENGE OF THE LICH");
-  SetWindowState(FLAG_WINDOW_RESIZABLE | FLAG_WINDOW_MAXIMIZED);
+  dc_kernels_init();
+  bool headless = false;
+  bool cpu_render = false;
+  const char* frame_out_path = NULL;
+  const char* golden_path = NULL;
+  const char* pack_path = NULL;
+  bool no_text = false;
+  bool startup_bench = false;
+  bool serial_load = false;
+  bool vsync = false;
+  const char* trace_path = NULL;
+  const char* record_path = NULL;
+  const char* replay_path = NULL;
+  unsigned long long seed = 1;
+  unsigned long headless_steps = 100000;
+  unsigned int swarm = 0;
+  unsigned int threads = 0;
+  for(int i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "--headless") == 0) headless = true;
+    else if(strcmp(argv[i], "--kernels") == 0 && i + 1 < argc) {
+      if(!dc_kernels_select(argv[++i])) fprintf(stderr, "kernels '%s' aren't available here, using %s\n", argv[i], dc_kernels.name);
+    }
+    else if(strcmp(argv[i], "--startup-bench") == 0) startup_bench = true;
+    else if(strcmp(argv[i], "--cpu-render") == 0) cpu_render = true;
+    else if(strcmp(argv[i], "--frame-out") == 0 && i + 1 < argc) frame_out_path = argv[++i];
+    else if(strcmp(argv[i], "--golden") == 0 && i + 1 < argc) golden_path = argv[++i];
+    else if(strcmp(argv[i], "--pack") == 0 && i + 1 < argc) pack_path = argv[++i];
+    else if(strcmp(argv[i], "--no-text") == 0) no_text = true;
+    else if(strcmp(argv[i], "--serial-load") == 0) serial_load = true;
+    else if(strcmp(argv[i], "--vsync") == 0) vsync = true;
+    else if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+    else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+    else if(strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+    else if(strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+    else if(strcmp(argv[i], "--steps") == 0 && i + 1 < argc) headless_steps = strtoul(argv[++i], NULL, 10);
+    else if(strcmp(argv[i], "--swarm") == 0 && i + 1 < argc) swarm = strtoul(argv[++i], NULL, 10);
+    else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = strtoul(argv[++i], NULL, 10);
+  }
+  dc_jobs_init(threads);
+  if(headless) {
+    int result = replay_path ? dc_run_replay(replay_path, trace_path) : dc_run_headless(headless_steps, swarm, seed, trace_path);
+    dc_jobs_shutdown();
+    return result;
+  }
+  if(cpu_render) {
+    int result = dc_run_cpu_render(headless_steps, swarm, seed, pack_path, no_text, frame_out_path, golden_path);
+    dc_jobs_shutdown();
+    return result;
+  }
+  if(startup_bench) {
+    int result = dc_run_startup_bench(pack_path);
+    dc_jobs_shutdown();
+    return result;
+  }
 
-  Image w_icon = LoadImage("./gfx/gmtk_icon.png");
-  SetWindowIcon(w_icon);
+  dc_InputLog replay = {0}, recording = {0};
+  if(replay_path) {
+    if(!dc_open_replay(&replay, replay_path)) return 1;
+    seed = replay.seed;
+  } else if(record_path && !dc_InputLog_create(&recording, record_path, seed, dc_kernels.name)) {
+    fprintf(stderr, "can't write %s\n", record_path);
+    return 1;
+  }
+
+  double startup_start = dc_time_now();
+  dc_Pack pack;
+  if(!dc_open_assets(&pack, pack_path)) return 1;
+  double pack_opened = dc_time_now();
 
+  // decoding starts right away so it overlaps with bringing up the window and audio device
+  dc_AssetLoad assets[ASSET_COUNT];
+  memcpy(assets, dc_game_assets, sizeof(assets));
+  dc_Loader loader;
+  dc_Loader_start(&loader, &pack, assets, ASSET_COUNT, !serial_load);
+
+  // the sim runs at SIM_HZ either way, this only decides how many frames get drawn in between
+  if(vsync) SetConfigFlags(FLAG_VSYNC_HINT);
+  InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "REVENGE OF THE LICH");
+  SetWindowState(FLAG_WINDOW_RESIZABLE | FLAG_WINDOW_MAXIMIZED);
   InitAudioDevice();
+  double devices_ready = dc_time_now();
+
+  while(!dc_Loader_done(&loader) && !WindowShouldClose()) {
+    BeginDrawing();
+      ClearBackground(BLACK);
+      int bar_width = GetScreenWidth() / 3;
+      int bar_x = (GetScreenWidth() - bar_width) / 2;
+      int bar_y = GetScreenHeight() / 2;
+      DrawText("loading...", bar_x, bar_y - 30, 20, WHITE);
+      DrawRectangle(bar_x, bar_y, bar_width * dc_Loader_progress(&loader), 8, WHITE);
+    EndDrawing();
+  }
+  dc_Loader_wait(&loader);
+  double assets_decoded = dc_time_now();
 
-  Texture2D f_tex = LoadTexture("./gfx/frame.png");
-  Rectangle f_rect = {0, 0, f_tex.width, f_tex.height};
+  Image w_icon = assets[ASSET_ICON].image;
+  SetWindowIcon(w_icon);
 
-  dc_Tilesets tilesets = {
-    .interface = LoadTexture("./gfx/oryx/Interface.png"), 
-    // .terrain = LoadTexture("./gfx/oryx/Terrain.png"), 
-    // .monsters = LoadTexture("./gfx/oryx/Monsters.png"), 
-    .avatar = LoadTexture("./gfx/oryx/Avatar.png"), 
-    .fx_general = LoadTexture("./gfx/oryx/FX_General.png"), 
-    .zach = LoadTexture("./gfx/gmtk_spritesheet.png")};
+  dc_Tilesets tilesets = {.atlas = dc_AssetLoad_texture(&assets[ASSET_ATLAS])};
+  // shadows are drawn as shapes, pointing those at a white patch of the atlas keeps them in the
+  // same batch as the sprites. the inset keeps filtering from picking up the neighbours
+  Rectangle white = DC_ATLAS_WHITE;
+  SetShapesTexture(tilesets.atlas, (Rectangle){white.x + 1, white.y + 1, white.width - 2, white.height - 2});
 
   RenderTexture2D r_target = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
   //SetTextureFilter(r_target.texture, TEXTURE_FILTER_POINT);
   Rectangle r_target_rect = {0, 0, r_target.texture.width, -r_target.texture.height};
-
-  Font font = LoadFontEx("./gfx/Perfect DOS VGA 437.ttf", 16.f*4, NULL, 0);
+  dc_RoomLayer room_layer = dc_RoomLayer_create();
+  dc_Hud hud = dc_Hud_create();
+  bool show_hud_stats = false;
+#ifdef DC_PROFILE
+  bool show_profiler = false;
+#endif
+
+  Font font = dc_AssetLoad_font(&assets[ASSET_FONT]);
   //SetTextureFilter(font.texture, TEXTURE_FILTER_POINT);
 
-  unsigned int number_of_rooms = ROOMS_LENGTH;
-  unsigned int current_room = 2 + 2 * FLOOR_WIDTH;
-  dc_Room** rooms = malloc(sizeof(dc_Room*) * number_of_rooms);
-  for(unsigned int i = 0; i < number_of_rooms; i++) {
-    rooms[i] = NULL;
-  }
-  rooms[current_room] = malloc(sizeof(dc_Room));
-  *rooms[current_room] = (dc_Room){0};
-  {
-    unsigned int fucking_door = rand() % 4;
-    if(fucking_door == 0) rooms[current_room]->door_north = true;
-    else if(fucking_door == 1) rooms[current_room]->door_west = true;
-    else if(fucking_door == 2) rooms[current_room]->door_east = true;
-    else if(fucking_door == 3) rooms[current_room]->door_south = true;
-  }
-  rooms[current_room]->remaining_monsters = 1;
-
-  dc_Frames frame_data = {
-    .skeleton_textures = {tilesets.zach, tilesets.zach},
-    .skeleton_rects = {(Rectangle){1 * TILE_WIDTH, 6 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT}, (Rectangle){2 * TILE_WIDTH, 6 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT}},
-    .skeleton_frames = 2,
-    .slice_textures = {tilesets.fx_general, tilesets.fx_general, tilesets.fx_general},
-    .slice_rects = {(Rectangle){12 * TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT}, (Rectangle){13 * TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT}, (Rectangle){14 * TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT}},
-    .slice_frames = 3,
-    .dwarf_textures = {tilesets.zach, tilesets.zach},
-    .dwarf_rects = {(Rectangle){1 * TILE_WIDTH, 4 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT}, (Rectangle){2 * TILE_WIDTH, 4 * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT}},
-    .dwarf_frames = 2
-  };
+  dc_Frames frame_data = dc_Frames_create(tilesets);
 
+  dc_Mixer mixer;
+  dc_Mixer_init(&mixer, MIXER_MAX_PLAYING);
   dc_Sounds sounds = {
-    .door_open = LoadSound("./sfx/door_open.wav")
+    .door_open = dc_Mixer_add(&mixer, ".ogg", assets[ASSET_DOOR_OPEN].data, assets[ASSET_DOOR_OPEN].size, 2, 2)
   };
-
-  dc_Actor* player = dc_Actor_create_player(&frame_data);
-
-  dc_Actor* actors[MAX_ACTORS] = {player};
-  actors[1] = dc_Actor_create_bat(&frame_data, (Vector2){250, 250});
-  for(int a = 2; a < MAX_ACTORS; a++) {
-    actors[a] = NULL;
-  }
+  double assets_loaded = dc_time_now();
+  printf("startup (%s decode): pack %.2fms, window + audio %.1fms, waiting on decode %.1fms, upload %.1fms, total %.1fms\n", serial_load ? "serial" : "parallel", (pack_opened - startup_start) * 1000, (devices_ready - pack_opened) * 1000, (assets_decoded - devices_ready) * 1000, (assets_loaded - assets_decoded) * 1000, (assets_loaded - startup_start) * 1000);
+
+  dc_World world;
+  dc_World_init(&world, &frame_data, seed);
+  dc_Rewind rewind;
+  dc_Rewind_init(&rewind, REWIND_FRAMES);
+  dc_Rewind_push(&rewind, &world);
+  dc_Interp interp = {0};
+  dc_DrawList draw_list = {0};
+  float sim_accumulator = 0; // real time the sim hasn't caught up on yet, always under SIM_DT between frames
+  dc_InputQueue input_queue; // a click from a frame that didn't get a sim step of its own waits in here
+  dc_InputQueue_init(&input_queue, dc_get_virtual_mouse());
+  // the aim the reticle was drawn with against the one read at the top of the frame, which is
+  // what it used to be drawn with, and presses against the frame the step they went in shows up
+  dc_Latency aim_latency = {0}, unlatched_aim_latency = {0}, press_latency = {0};
+  double frame_pressed = 0; // earliest press that went into a step this frame
+  double replay_clock = 0;
+  double sim_clock = 0;
+  float replay_dt = SIM_DT;
+  bool replay_drifted = false;
+  const char* replay_ended = NULL; // shown over the frozen world once the log runs out
 
   Camera2D cam = {(Vector2){0}, (Vector2){0}, 0.f, 1.f};
 
-  unsigned int rooms_cleared = 0;
-
   while(!WindowShouldClose()) {
-    float dt = MIN(GetFrameTime(), 1000.f/15.f); // cap how slow the game can run because i'm not doing interpolation for your commodore 64
-    
-    if(player != NULL) {
-      Vector2 p_input_v = dc_get_player_input_vector();
-      player->velocity.x = p_input_v.x * 100;
-      player->velocity.y = p_input_v.y * 100;
-      if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        for(int a = 0; a < MAX_ACTORS; a++) {
-          if(actors[a] != NULL) continue;
-          Vector2 mouse_pos = GetMousePosition();
-          Vector2 screen_scaling = dc_get_screen_scaling_percent();
-          float dx = mouse_pos.x * screen_scaling.x - player->position.x;
-          float dy = mouse_pos.y * screen_scaling.y - player->position.y;
-          float rot = atan2(dy, dx);
-          static const int slice_distance = 12;
-          Vector2 slice_pos = (Vector2){player->position.x + slice_distance * cos(rot), player->position.y + slice_distance * sin(rot)};
-          actors[a] = dc_Actor_create_player_slice(&frame_data, slice_pos, atan2(dy, dx) * RAD2DEG + 135);
-          break;
+    dc_poll_input(&input_queue);
+    double frame_polled = input_queue.sampled_time;
+    uint32_t pressed = dc_InputQueue_pressed(&input_queue);
+    if(pressed & CONTROL_BIT(CONTROL_HUD_STATS)) show_hud_stats = !show_hud_stats;
+#ifdef DC_PROFILE
+    if(pressed & CONTROL_BIT(CONTROL_PROFILER)) show_profiler = !show_profiler;
+    if(pressed & CONTROL_BIT(CONTROL_TRACE)) printf(dc_prof_write_trace("trace.json") ? "wrote trace.json\n" : "couldn't write trace.json\n");
+#endif
+    frame_pressed = 0;
+    unsigned int events = 0;
+    float alpha = 1; // where between the last two sim states this frame gets drawn
+    if(replay.file) {
+      // however many recorded steps fit in the time that's passed, so it plays back at the
+      // speed it was played. a hitch gets dropped the same as it does live
+      replay_clock += MIN(GetFrameTime(), MAX_FRAME_TIME);
+      dc_InputRecord record;
+      while(replay.file && sim_clock < replay_clock) {
+        dc_InputLogEntry entry = dc_InputLog_read(&replay, &record);
+        if(entry == DC_INPUT_LOG_CHECK) {
+          if(dc_replay_check(&replay, &world)) continue;
+          replay_drifted = true;
         }
-      }
-    }
-
-    for(int a = 0; a < MAX_ACTORS; a++) {
-      if(actors[a] != NULL && actors[a]->ai != NULL) actors[a]->ai(actors[a], player);
-    }
-
-    for(int a = 0; a < MAX_ACTORS; a++) {
-      if(actors[a] != NULL) dc_Actor_update(actors[a], dt);
-    }
-
-    for(int a = 0; a < MAX_ACTORS; a++) {
-      if(actors[a] == NULL) continue;
-      if(actors[a] == player && rooms[current_room]->doors_opened) {
-        // XXX: magic number bullshit
-        Rectangle north_door_hitbox = (Rectangle){TILE_WIDTH * 9.5, TILE_HEIGHT * 1.8, TILE_WIDTH, TILE_HEIGHT};
-        Rectangle north_wall_hitbox = (Rectangle){TILE_WIDTH * 1.5, TILE_HEIGHT * 1.8, TILE_WIDTH * 17, TILE_HEIGHT};
-        Rectangle south_door_hitbox = (Rectangle){TILE_WIDTH * 8.5, TILE_HEIGHT * 5.6, TILE_WIDTH, TILE_HEIGHT}; // 8.5 and not 9.5?
-        Rectangle south_wall_hitbox = (Rectangle){TILE_WIDTH * 1.5, TILE_HEIGHT * 5.6, TILE_WIDTH * 17, TILE_HEIGHT};
-        Rectangle west_wall_hitbox = (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT * 5};
-        Rectangle west_door_hitbox = (Rectangle){TILE_WIDTH * 0.5, TILE_HEIGHT * 4, TILE_WIDTH, TILE_HEIGHT};
-        Rectangle east_wall_hitbox = (Rectangle){TILE_WIDTH * 18.5, TILE_HEIGHT * 2, TILE_WIDTH, TILE_HEIGHT * 5};
-        Rectangle east_door_hitbox = (Rectangle){TILE_WIDTH * 18.5, TILE_HEIGHT * 4, TILE_WIDTH, TILE_HEIGHT};
-
-        // my beautiful codebase is getting worse as the hour draws near
-        unsigned int old_room_x = current_room % FLOOR_WIDTH;
-        unsigned int old_room_y = current_room / FLOOR_WIDTH;
-        if(rooms[current_room]->door_north && CheckCollisionPointRec(player->position, north_door_hitbox)) {
-          unsigned int new_room_x = old_room_x;
-          unsigned int new_room_y = old_room_y-1;
-          dc_Room_generate(rooms, old_room_x, old_room_y, new_room_x, new_room_y, rooms_cleared);
-          current_room = new_room_x + new_room_y * FLOOR_WIDTH;
-          player->position.y = TILE_HEIGHT * 3;
-          // we don't check for errors at all, and will probably just fail to spawn em if we some how max out our actors array /shrug
-          dc_spawn_actor(&frame_data, actors, rooms[current_room]->remaining_monsters);
-          break;
-        } else if(rooms[current_room]->door_south && CheckCollisionPointRec(player->position, south_door_hitbox)) {
-          unsigned int new_room_x = old_room_x;
-          unsigned int new_room_y = old_room_y+1;
-          dc_Room_generate(rooms, old_room_x, old_room_y, new_room_x, new_room_y, rooms_cleared);
-          current_room = new_room_x + new_room_y * FLOOR_WIDTH;
-          player->position.y = TILE_HEIGHT * 5;
-          dc_spawn_actor(&frame_data, actors, rooms[current_room]->remaining_monsters);
-          break;
-        } else if(rooms[current_room]->door_west && CheckCollisionPointRec(player->position, west_door_hitbox)) {
-          unsigned int new_room_x = old_room_x-1;
-          unsigned int new_room_y = old_room_y;
-          dc_Room_generate(rooms, old_room_x, old_room_y, new_room_x, new_room_y, rooms_cleared);
-          current_room = new_room_x + new_room_y * FLOOR_WIDTH;
-          player->position.x = TILE_WIDTH * 18;
-          dc_spawn_actor(&frame_data, actors, rooms[current_room]->remaining_monsters);
-          break;
-        } else if(rooms[current_room]->door_east && CheckCollisionPointRec(player->position, east_door_hitbox)) {
-          unsigned int new_room_x = old_room_x+1;
-          unsigned int new_room_y = old_room_y;
-          dc_Room_generate(rooms, old_room_x, old_room_y, new_room_x, new_room_y, rooms_cleared);
-          current_room = new_room_x + new_room_y * FLOOR_WIDTH;
-          player->position.x = TILE_WIDTH * 2;
-          dc_spawn_actor(&frame_data, actors, rooms[current_room]->remaining_monsters);
+        if(entry != DC_INPUT_LOG_STEP) {
+          printf("replay %s after %lu steps, state %016llx\n", replay_drifted ? "stopped" : "finished", replay.steps, dc_World_hash(&world));
+          replay_ended = replay_drifted ? "replay drifted, esc to quit" : "replay over, esc to quit";
+          dc_InputLog_close(&replay);
           break;
         }
-
-        // nah get out of that there wall
-        if(CheckCollisionPointRec(player->position, north_wall_hitbox)) {
-          actors[a]->position.x -= actors[a]->velocity.x * dt;
-          actors[a]->position.y -= actors[a]->velocity.y * dt;
-        } else if(CheckCollisionPointRec(player->position, south_wall_hitbox)) {
-          actors[a]->position.x -= actors[a]->velocity.x * dt;
-          actors[a]->position.y -= actors[a]->velocity.y * dt;
-        } else if(CheckCollisionPointRec(player->position, west_wall_hitbox)) {
-          actors[a]->position.x -= actors[a]->velocity.x * dt;
-          actors[a]->position.y -= actors[a]->velocity.y * dt;
-        } else if(CheckCollisionPointRec(player->position, east_wall_hitbox)) {
-          actors[a]->position.x -= actors[a]->velocity.x * dt;
-          actors[a]->position.y -= actors[a]->velocity.y * dt;
-        }
-      } else {
-        actors[a]->position.x = dc_clampf(actors[a]->position.x, TILE_WIDTH * 2, TILE_WIDTH * 18);
-        actors[a]->position.y = dc_clampf(actors[a]->position.y, TILE_HEIGHT * 2.8, TILE_HEIGHT * 5.6);
+        dc_Interp_capture(&interp, &world.actors);
+        dc_sim_step(&world, dc_InputRecord_input(record), record.dt);
+        if(world.events & DC_EVENT_ROOM_CHANGED) dc_Interp_reset(&interp);
+        sim_clock += record.dt;
+        replay_dt = record.dt;
+        events |= world.events;
+      }
+      // the sim is up to one step ahead of the clock
+      if(replay.file) alpha = 1 - (sim_clock - replay_clock) / replay_dt;
+    } else if(!replay_path) {
+      // F5/F6 quicksave and load, hold R to rewind. none of it while recording, the log
+      // would stop matching what happened
+      bool time_travel = !recording.file;
+      if(time_travel && (pressed & CONTROL_BIT(CONTROL_QUICKSAVE))) printf(dc_snapshot_save(&world, QUICKSAVE_PATH) ? "saved " QUICKSAVE_PATH "\n" : "couldn't write " QUICKSAVE_PATH "\n");
+      if(time_travel && (pressed & CONTROL_BIT(CONTROL_QUICKLOAD)) && dc_snapshot_load(&world, QUICKSAVE_PATH)) {
+        room_layer.dirty = true;
+        dc_Interp_reset(&interp);
       }
-    }
-
-    for(int a = 0; a < MAX_ACTORS; a++) {
-      if(actors[a] != NULL) dc_Actor_handle_collisions(actors);
-    }
 
-    for(int a = 0; a < MAX_ACTORS; a++) {
-      if(actors[a] != NULL && actors[a]->should_be_freed) {
-        if(actors[a]->ai != NULL) {
-          rooms[current_room]->remaining_monsters--;
-          if(rooms[current_room]->remaining_monsters == 0 && !rooms[current_room]->doors_opened) {
-            PlaySound(sounds.door_open);
-            rooms[current_room]->doors_opened = true;
-            rooms_cleared++;
-          }
+      // fixed steps for however much time has built up. a slow frame runs a few steps, a fast
+      // one might not run any and just draws further along between the last two
+      sim_accumulator += MIN(GetFrameTime(), MAX_FRAME_TIME);
+      while(sim_accumulator >= SIM_DT) {
+        sim_accumulator -= SIM_DT;
+        // each step gets what happened during its slice of real time, which ends wherever the
+        // sim's caught up to. the last one also takes everything since, it's this frame's input
+        // and waiting would only put it on screen a frame later
+        bool last = sim_accumulator < SIM_DT;
+        dc_InputStep step = dc_InputQueue_take(&input_queue, last ? frame_polled : frame_polled - sim_accumulator);
+        if(time_travel && (step.held & CONTROL_BIT(CONTROL_REWIND))) {
+          if(dc_Rewind_back(&rewind, &world, 1)) room_layer.dirty = true;
+          dc_Interp_reset(&interp);
+          continue;
         }
-        free(actors[a]); // we *shouldn't* need to make ->textures or ->sources NULL
-        if(actors[a] == player) player = NULL;
-        actors[a] = NULL;
+        if(step.first_press && !frame_pressed) frame_pressed = step.first_press;
+        dc_InputRecord record = dc_InputStep_record(step, SIM_DT);
+        if(recording.file) dc_InputLog_write(&recording, record);
+        dc_Interp_capture(&interp, &world.actors);
+        dc_sim_step(&world, dc_InputRecord_input(record), record.dt);
+        if(recording.file && recording.steps % DC_INPUT_LOG_CHECK_STEPS == 0) dc_InputLog_write_check(&recording, dc_World_hash(&world));
+        if(world.events & DC_EVENT_ROOM_CHANGED) dc_Interp_reset(&interp);
+        events |= world.events;
+        if(time_travel) dc_Rewind_push(&rewind, &world);
       }
+      alpha = sim_accumulator / SIM_DT;
     }
+    // a replay doesn't listen to the live input, it just can't be left to pile up
+    if(replay_path) dc_InputQueue_take(&input_queue, frame_polled);
+    if(events & DC_EVENT_DOORS_OPENED) dc_Mixer_play(&mixer, sounds.door_open, 1.f);
+    dc_Mixer_update(&mixer);
+    if(events & (DC_EVENT_DOORS_OPENED | DC_EVENT_ROOM_CHANGED)) room_layer.dirty = true;
+    int player = dc_World_player(&world);
+
+    dc_Room* room = dc_World_room(&world);
 
     BeginDrawing();
+      DC_PROF_BEGIN(DC_PHASE_ROOM_DRAW);
+      dc_RoomLayer_update(&room_layer, tilesets, world.room_x, world.room_y, room);
+      DC_PROF_END(DC_PHASE_ROOM_DRAW);
+      DC_PROF_BEGIN(DC_PHASE_HUD);
+      if(player >= 0) {
+        dc_Health health = world.actors.health[player];
+        dc_Hud_update(&hud, tilesets, font, true, health.hp, health.hp_max, room->remaining_monsters);
+      } else dc_Hud_update(&hud, tilesets, font, false, 0, 0, 0);
+      DC_PROF_END(DC_PHASE_HUD);
       BeginTextureMode(r_target);
       ClearBackground(BLACK);
 
       BeginMode2D(cam);
-      if(rooms_cleared >= ROOMS_TO_WIN) {
-        DrawTextEx(font, TextFormat("You escaped the dungeon and \nenacted revenge on \nthe town of adventurers.\n\nYou win!"), (Vector2){20, 20}, 16.f, 0.1f, WHITE);
+      if(world.rooms_cleared >= ROOMS_TO_WIN) {
+        dc_draw.text(font, DC_WIN_TEXT, (Vector2){20, 20}, 16.f, 0.1f, WHITE);
       } else {
-        dc_Room_draw(tilesets, rooms[current_room]);
-
-        for(int a = 0; a < MAX_ACTORS; a++) {
-          if(actors[a] != NULL) dc_Actor_draw(actors[a]);
+        DC_PROF_BEGIN(DC_PHASE_ROOM_DRAW);
+        dc_RoomLayer_draw(&room_layer);
+        DC_PROF_END(DC_PHASE_ROOM_DRAW);
+
+        DC_PROF_BEGIN(DC_PHASE_ACTOR_DRAW);
+        dc_DrawList_clear(&draw_list);
+        for(unsigned int a = 0; a < world.actors.count; a++) {
+          dc_DrawList_add(&draw_list, &world.actors, a, dc_Interp_position(&interp, &world.actors, a, alpha));
         }
+        dc_DrawList_sort(&draw_list);
+        dc_DrawList_draw(&draw_list, &frame_data, &world.actors, dc_iframe_flash(GetTime()));
+        dc_Effects_draw(&world.effects, &frame_data);
+        DC_PROF_END(DC_PHASE_ACTOR_DRAW);
         EndMode2D();
 
-        DrawTexturePro(f_tex, f_rect, f_rect, (Vector2){0}, 0.f, WHITE);
-
         // removed debug shit because I am bad a trig
         /*{
           Vector2 mouse_pos = GetMousePosition();
@@ -655,50 +942,72 @@ int main(int argc, char** argv) {
           DrawCircle(player->position.x + 16 * cos(rot), player->position.y + 16 * sin(rot), 4.f, BLUE);
           }*/
 
-        if(player != NULL) {
-          dc_draw_player_health(tilesets, player->hp, player->hp_max);
-          dc_draw_player_targeting(tilesets, player);
-        }
-
-
-        if(player == NULL) {
-          DrawTextEx(font, "Game Over!", (Vector2){100, 20}, 16.f, 0.1f, WHITE);
-        } else {
-          DrawTextEx(font, TextFormat("Remaining: %d", rooms[current_room]->remaining_monsters), (Vector2){100, 20}, 16.f, 0.1f, WHITE);
+        DC_PROF_BEGIN(DC_PHASE_HUD);
+        dc_Hud_draw(&hud);
+        DC_PROF_END(DC_PHASE_HUD);
+#ifdef DC_PROFILE
+        if(show_profiler) dc_draw_profiler();
+#endif
+        if(show_hud_stats) {
+          DrawText(TextFormat("input: aim %.1fms old at present (%.1fms unlatched), slices %.1fms", dc_Latency_mean_ms(&aim_latency), dc_Latency_mean_ms(&unlatched_aim_latency), dc_Latency_mean_ms(&press_latency)), 4, SCREEN_HEIGHT - 48, 10, WHITE);
+          DrawText(TextFormat("hud rebuilds: %u this frame, %lu total", hud.rebuilds_this_frame, hud.rebuilds), 4, SCREEN_HEIGHT - 12, 10, WHITE);
+          DrawText(TextFormat("actors: %u drawn, %u culled", draw_list.count, draw_list.culled), 4, SCREEN_HEIGHT - 36, 10, WHITE);
+          DrawText(TextFormat("voices: %u/%u playing, %lu stolen, %lu dropped", mixer.playing, mixer.max_playing, mixer.steals, mixer.drops), 4, SCREEN_HEIGHT - 24, 10, WHITE);
         }
         // SetTextureFilter
 
+        // follows the mouse, so it's drawn last off a fresh poll. anything pressed in the
+        // meantime waits in the queue for the next step
+        if(player >= 0) {
+          PollInputEvents();
+          dc_poll_input(&input_queue);
+          dc_draw_player_targeting(tilesets, world.actors.position[player], input_queue.sampled_aim);
+        }
       }
+      if(replay_ended) DrawText(replay_ended, (SCREEN_WIDTH - MeasureText(replay_ended, 10)) / 2, SCREEN_HEIGHT / 2 - 5, 10, WHITE);
       EndTextureMode();
+      DC_PROF_BEGIN(DC_PHASE_BLIT);
       Rectangle r_window_rect = {0, 0, GetScreenWidth(), GetScreenHeight()};
       DrawTexturePro(r_target.texture, r_target_rect, r_window_rect, (Vector2){0, 0}, 0.f, WHITE);
+      DC_PROF_END(DC_PHASE_BLIT);
+      DC_PROF_BEGIN(DC_PHASE_PRESENT);
     EndDrawing();
+    DC_PROF_END(DC_PHASE_PRESENT);
+    double presented = dc_time_now();
+    if(player >= 0 && world.rooms_cleared < ROOMS_TO_WIN) {
+      dc_Latency_add(&aim_latency, presented - input_queue.sampled_time);
+      dc_Latency_add(&unlatched_aim_latency, presented - frame_polled);
+    }
+    if(frame_pressed) dc_Latency_add(&press_latency, presented - frame_pressed);
+    DC_PROF_FRAME();
   }
+  printf("input latency to present: aim %.1fms late latched (%.1fms read at the top of the frame, max %.1fms), slices %.1fms (max %.1fms) over %lu\n", dc_Latency_mean_ms(&aim_latency), dc_Latency_mean_ms(&unlatched_aim_latency), unlatched_aim_latency.max * 1000, dc_Latency_mean_ms(&press_latency), press_latency.max * 1000, press_latency.count);
 
   CloseWindow();
-  UnloadTexture(f_tex);
-  UnloadTexture(tilesets.interface);
-  // UnloadTexture(tilesets.terrain);
-  // UnloadTexture(tilesets.monsters);
-  UnloadTexture(tilesets.avatar);
-  UnloadTexture(tilesets.fx_general);
-  UnloadTexture(tilesets.zach);
-  for(unsigned int i = 0; i < ROOMS_LENGTH; i++) {
-    if(rooms[i] != NULL) free(rooms[i]);
-  }
-  free(rooms);
-
-  for(unsigned int a = 0; a < MAX_ACTORS; a++) {
-    if(actors[a] != NULL) free(actors[a]);
-  }
+  dc_jobs_shutdown();
+  UnloadRenderTexture(room_layer.target);
+  UnloadRenderTexture(hud.target);
+  UnloadRenderTexture(r_target);
+  UnloadTexture(tilesets.atlas);
+
+  dc_Rewind_free(&rewind);
+  dc_Interp_free(&interp);
+  dc_DrawList_free(&draw_list);
+  if(recording.file) dc_InputLog_write_check(&recording, dc_World_hash(&world));
+  dc_World_free(&world);
 
   UnloadFont(font);
 
-  UnloadSound(sounds.door_open);
+  dc_Mixer_free(&mixer);
 
   UnloadImage(w_icon);
 
   CloseAudioDevice();
 
-  return 0;
+  dc_Pack_close(&pack);
+  dc_InputLog_close(&replay);
+  bool recorded = dc_InputLog_close(&recording);
+  if(!recorded) fprintf(stderr, "couldn't write all of %s, the recording's cut short\n", record_path);
+
+  return replay_drifted || !recorded ? 1 : 0;
 }
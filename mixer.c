@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include "mixer.h"
+
+void dc_Mixer_init(dc_Mixer* mixer, unsigned int max_playing) {
+  *mixer = (dc_Mixer){.max_playing = max_playing < DC_MIXER_VOICES ? max_playing : DC_MIXER_VOICES};
+}
+
+void dc_Mixer_free(dc_Mixer* mixer) {
+  for(unsigned int v = 0; v < mixer->voice_count; v++) {
+    UnloadMusicStream(mixer->voices[v].stream);
+  }
+  *mixer = (dc_Mixer){0};
+}
+
+int dc_Mixer_add(dc_Mixer* mixer, const char* type, const unsigned char* data, unsigned int size, unsigned int voices, int priority) {
+  if(mixer->sound_count >= DC_MIXER_SOUNDS || mixer->voice_count + voices > DC_MIXER_VOICES) {
+    fprintf(stderr, "mixer: out of room for another sound with %u voices\n", voices);
+    return -1;
+  }
+  unsigned int id = mixer->sound_count;
+  unsigned int first = mixer->voice_count;
+  for(unsigned int v = 0; v < voices; v++) {
+    Music stream = LoadMusicStreamFromMemory(type, data, size);
+    if(stream.frameCount == 0) {
+      fprintf(stderr, "mixer: can't decode a %s sound\n", type);
+      for(unsigned int u = first; u < first + v; u++) UnloadMusicStream(mixer->voices[u].stream);
+      return -1;
+    }
+    stream.looping = false;
+    mixer->voices[first + v] = (dc_Voice){.stream = stream, .sound = id};
+  }
+  mixer->sounds[id] = (dc_MixerSound){data, size, first, voices, priority};
+  mixer->voice_count += voices;
+  mixer->sound_count++;
+  return id;
+}
+
+static void dc_Mixer_stop(dc_Mixer* mixer, dc_Voice* voice) {
+  // stopping rewinds the decoder too, so it's ready to go again
+  StopMusicStream(voice->stream);
+  voice->playing = false;
+  mixer->playing--;
+}
+
+bool dc_Mixer_play(dc_Mixer* mixer, int sound, float volume) {
+  if(sound < 0 || (unsigned int)sound >= mixer->sound_count) return false;
+  const dc_MixerSound* s = &mixer->sounds[sound];
+  if(s->voice_count == 0) return false;
+
+  // a free copy of this sound, else its oldest one starts over
+  dc_Voice* voice = NULL;
+  for(unsigned int v = s->first_voice; v < s->first_voice + s->voice_count; v++) {
+    dc_Voice* candidate = &mixer->voices[v];
+    if(!candidate->playing) {
+      voice = candidate;
+      break;
+    }
+    if(!voice || candidate->started < voice->started) voice = candidate;
+  }
+
+  if(voice->playing) {
+    dc_Mixer_stop(mixer, voice);
+    mixer->steals++;
+  } else if(mixer->playing >= mixer->max_playing) {
+    // at the cap, something quieter and older has to make way
+    dc_Voice* victim = NULL;
+    for(unsigned int v = 0; v < mixer->voice_count; v++) {
+      dc_Voice* candidate = &mixer->voices[v];
+      if(!candidate->playing) continue;
+      int priority = mixer->sounds[candidate->sound].priority;
+      if(priority > s->priority) continue;
+      int victim_priority = victim ? mixer->sounds[victim->sound].priority : 0;
+      if(!victim || priority < victim_priority || (priority == victim_priority && candidate->started < victim->started)) victim = candidate;
+    }
+    if(!victim) {
+      mixer->drops++;
+      return false;
+    }
+    dc_Mixer_stop(mixer, victim);
+    mixer->steals++;
+  }
+
+  SetMusicVolume(voice->stream, volume);
+  PlayMusicStream(voice->stream);
+  voice->playing = true;
+  voice->started = ++mixer->plays;
+  mixer->playing++;
+  return true;
+}
+
+void dc_Mixer_update(dc_Mixer* mixer) {
+  for(unsigned int v = 0; v < mixer->voice_count; v++) {
+    dc_Voice* voice = &mixer->voices[v];
+    if(!voice->playing) continue;
+    UpdateMusicStream(voice->stream);
+    if(!IsMusicStreamPlaying(voice->stream)) dc_Mixer_stop(mixer, voice);
+  }
+}
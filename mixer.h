@@ -0,0 +1,44 @@
+#pragma once
+#include <raylib.h>
+
+#define DC_MIXER_SOUNDS 16
+#define DC_MIXER_VOICES 32 // streams opened up front across every sound, playing never allocates
+
+// a sound left compressed wherever it already lives (the mapped pack). each one gets a fixed
+// number of decoder streams, that's how many copies of it can overlap
+typedef struct {
+  const unsigned char* data;
+  unsigned int size;
+  unsigned int first_voice;
+  unsigned int voice_count;
+  int priority; // a play can only steal a voice from sounds at or below its own priority
+} dc_MixerSound;
+
+typedef struct {
+  Music stream; // decodes straight out of the sound's data as it plays
+  unsigned int sound;
+  unsigned long started; // play order, the oldest goes first when something has to be stolen
+  bool playing;
+} dc_Voice;
+
+typedef struct {
+  dc_MixerSound sounds[DC_MIXER_SOUNDS];
+  unsigned int sound_count;
+  dc_Voice voices[DC_MIXER_VOICES];
+  unsigned int voice_count;
+  unsigned int max_playing; // cap on what the audio device mixes at once, however big the fight
+  unsigned int playing;
+  unsigned long plays;
+  unsigned long steals; // voices cut off early to make room
+  unsigned long drops; // plays that lost out to louder sounds
+} dc_Mixer;
+
+void dc_Mixer_init(dc_Mixer* mixer, unsigned int max_playing);
+void dc_Mixer_free(dc_Mixer* mixer);
+// type is the file extension (".ogg"). data has to stay put until dc_Mixer_free. returns the
+// sound's id, or -1 (with a message on stderr) if it can't be decoded or there aren't the voices
+int dc_Mixer_add(dc_Mixer* mixer, const char* type, const unsigned char* data, unsigned int size, unsigned int voices, int priority);
+// restarts the oldest copy when all of the sound's voices are busy. false if it got dropped
+bool dc_Mixer_play(dc_Mixer* mixer, int sound, float volume);
+// once a frame: tops up the playing streams and takes back the ones that finished
+void dc_Mixer_update(dc_Mixer* mixer);
@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pack.h"
+
+#ifdef _WIN32
+#define DC_PACK_NO_MMAP
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static bool dc_Pack_validate(dc_Pack* pack, const char* path) {
+  const dc_PackHeader* header = (const dc_PackHeader*)pack->base;
+  if(pack->size < sizeof(dc_PackHeader) || memcmp(header->magic, DC_PACK_MAGIC, 4) != 0 || header->version != DC_PACK_VERSION) {
+    fprintf(stderr, "%s isn't a version %d asset pack, rebuild it with `make`\n", path, DC_PACK_VERSION);
+    return false;
+  }
+  pack->entries = (const dc_PackEntry*)(pack->base + sizeof(dc_PackHeader));
+  pack->count = header->count;
+  if(sizeof(dc_PackHeader) + sizeof(dc_PackEntry) * (size_t)pack->count > pack->size) {
+    fprintf(stderr, "%s is truncated\n", path);
+    return false;
+  }
+  for(unsigned int e = 0; e < pack->count; e++) {
+    if(pack->entries[e].offset + pack->entries[e].size > pack->size) {
+      fprintf(stderr, "%s is truncated\n", path);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool dc_Pack_open(dc_Pack* pack, const char* path) {
+  *pack = (dc_Pack){0};
+#ifdef DC_PACK_NO_MMAP
+  FILE* f = fopen(path, "rb");
+  if(!f) {
+    fprintf(stderr, "can't open %s\n", path);
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  unsigned char* data = malloc(size > 0 ? size : 1);
+  pack->size = fread(data, 1, size > 0 ? size : 0, f);
+  pack->base = data;
+  fclose(f);
+#else
+  int fd = open(path, O_RDONLY);
+  if(fd < 0) {
+    fprintf(stderr, "can't open %s\n", path);
+    return false;
+  }
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size == 0) {
+    fprintf(stderr, "can't read %s\n", path);
+    close(fd);
+    return false;
+  }
+  // the mapping stays valid after the fd is closed
+  void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED) {
+    fprintf(stderr, "can't map %s\n", path);
+    return false;
+  }
+  pack->base = base;
+  pack->size = st.st_size;
+  pack->mapped = true;
+#endif
+  if(!dc_Pack_validate(pack, path)) {
+    dc_Pack_close(pack);
+    return false;
+  }
+  return true;
+}
+
+void dc_Pack_close(dc_Pack* pack) {
+#ifndef DC_PACK_NO_MMAP
+  if(pack->mapped) munmap((void*)pack->base, pack->size);
+#endif
+  if(!pack->mapped) free((void*)pack->base);
+  *pack = (dc_Pack){0};
+}
+
+const unsigned char* dc_Pack_find(const dc_Pack* pack, const char* name, unsigned int* size) {
+  // a handful of entries, a linear scan is fine
+  for(unsigned int e = 0; e < pack->count; e++) {
+    if(strncmp(pack->entries[e].name, name, DC_PACK_NAME_LENGTH) == 0) {
+      if(size) *size = pack->entries[e].size;
+      return pack->base + pack->entries[e].offset;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// assets.pak: a header, an index, then each file's bytes starting on a DC_PACK_ALIGN boundary.
+// written by tools/pack.c, little endian, and read straight out of the mapped file
+#define DC_PACK_MAGIC "DCPK"
+#define DC_PACK_VERSION 1
+#define DC_PACK_ALIGN 64
+#define DC_PACK_NAME_LENGTH 48
+
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t count;
+  uint32_t reserved;
+} dc_PackHeader;
+
+typedef struct {
+  char name[DC_PACK_NAME_LENGTH]; // path as given to the packer, e.g. "gfx/atlas.png"
+  uint64_t offset; // from the start of the file
+  uint64_t size;
+} dc_PackEntry;
+
+typedef struct {
+  const unsigned char* base;
+  size_t size;
+  const dc_PackEntry* entries;
+  unsigned int count;
+  bool mapped; // false when we had to fall back to reading it into memory
+} dc_Pack;
+
+// maps the pack, false (with a message on stderr) if it's missing or not a pack
+bool dc_Pack_open(dc_Pack* pack, const char* path);
+void dc_Pack_close(dc_Pack* pack);
+// points into the mapping, NULL if it's not in there
+const unsigned char* dc_Pack_find(const dc_Pack* pack, const char* name, unsigned int* size);
@@ -0,0 +1,142 @@
+#include "prof.h"
+
+#ifdef DC_PROFILE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "dc.h"
+
+typedef struct {
+  dc_Phase phase;
+  double start; // seconds, dc_time_now
+  double duration;
+} dc_ProfEvent;
+
+typedef struct {
+  double start;
+  double duration;
+  double phase_total[DC_PHASE_COUNT];
+  dc_ProfEvent events[DC_PROF_EVENTS_PER_FRAME];
+  unsigned int event_count;
+} dc_ProfFrame;
+
+static struct {
+  dc_ProfFrame frames[DC_PROF_FRAMES];
+  unsigned long head; // frames published so far, frames[head % DC_PROF_FRAMES] is being written
+  double open[DC_PHASE_COUNT];
+  double epoch;
+} dc_prof;
+
+static const char* dc_prof_phase_names[DC_PHASE_COUNT] = {
+  [DC_PHASE_INPUT] = "input",
+  [DC_PHASE_AI] = "ai",
+  [DC_PHASE_UPDATE] = "update",
+  [DC_PHASE_WALLS] = "walls",
+  [DC_PHASE_COLLISIONS] = "collisions",
+  [DC_PHASE_FREE_PASS] = "free pass",
+  [DC_PHASE_STAGE] = "stage",
+  [DC_PHASE_ROOM_DRAW] = "room draw",
+  [DC_PHASE_ACTOR_DRAW] = "actor draw",
+  [DC_PHASE_HUD] = "hud",
+  [DC_PHASE_BLIT] = "blit",
+  [DC_PHASE_PRESENT] = "present"
+};
+
+static dc_ProfFrame* dc_prof_current(void) {
+  dc_ProfFrame* frame = &dc_prof.frames[dc_prof.head % DC_PROF_FRAMES];
+  if(frame->start == 0) {
+    if(dc_prof.epoch == 0) dc_prof.epoch = dc_time_now();
+    frame->start = dc_time_now();
+  }
+  return frame;
+}
+
+void dc_prof_begin(dc_Phase phase) {
+  dc_prof_current();
+  dc_prof.open[phase] = dc_time_now();
+}
+
+void dc_prof_end(dc_Phase phase) {
+  double now = dc_time_now();
+  dc_ProfFrame* frame = dc_prof_current();
+  double duration = now - dc_prof.open[phase];
+  frame->phase_total[phase] += duration;
+  if(frame->event_count < DC_PROF_EVENTS_PER_FRAME) {
+    frame->events[frame->event_count++] = (dc_ProfEvent){phase, dc_prof.open[phase], duration};
+  }
+}
+
+void dc_prof_frame(void) {
+  dc_ProfFrame* frame = dc_prof_current();
+  frame->duration = dc_time_now() - frame->start;
+  unsigned long head = __atomic_load_n(&dc_prof.head, __ATOMIC_RELAXED);
+  // clear the next slot before it's handed out, then publish this one
+  dc_prof.frames[(head + 1) % DC_PROF_FRAMES] = (dc_ProfFrame){0};
+  __atomic_store_n(&dc_prof.head, head + 1, __ATOMIC_RELEASE);
+}
+
+const char* dc_prof_phase_name(dc_Phase phase) {
+  return dc_prof_phase_names[phase];
+}
+
+static int dc_prof_compare(const void* a, const void* b) {
+  float x = *(const float*)a, y = *(const float*)b;
+  return (x > y) - (x < y);
+}
+
+// the published frames still in the ring, oldest first. the slot after the newest one is the
+// one being written (or just cleared), so that's left out
+static unsigned int dc_prof_published(unsigned long* first) {
+  unsigned long head = __atomic_load_n(&dc_prof.head, __ATOMIC_ACQUIRE);
+  unsigned int count = head < DC_PROF_FRAMES - 1 ? head : DC_PROF_FRAMES - 1;
+  *first = head - count;
+  return count;
+}
+
+static unsigned int dc_prof_percentile_of(int phase, float p, float* ms) {
+  static float samples[DC_PROF_FRAMES];
+  unsigned long first;
+  unsigned int count = dc_prof_published(&first);
+  for(unsigned int f = 0; f < count; f++) {
+    const dc_ProfFrame* frame = &dc_prof.frames[(first + f) % DC_PROF_FRAMES];
+    samples[f] = (phase < 0 ? frame->duration : frame->phase_total[phase]) * 1000;
+  }
+  if(count == 0) {
+    *ms = 0;
+    return 0;
+  }
+  qsort(samples, count, sizeof(float), dc_prof_compare);
+  unsigned int idx = (unsigned int)(p / 100.f * (count - 1) + 0.5f);
+  *ms = samples[idx < count ? idx : count - 1];
+  return count;
+}
+
+unsigned int dc_prof_percentile(dc_Phase phase, float p, float* ms) {
+  return dc_prof_percentile_of(phase, p, ms);
+}
+
+unsigned int dc_prof_frame_percentile(float p, float* ms) {
+  return dc_prof_percentile_of(-1, p, ms);
+}
+
+bool dc_prof_write_trace(const char* path) {
+  FILE* f = fopen(path, "w");
+  if(!f) return false;
+  unsigned long first;
+  unsigned int count = dc_prof_published(&first);
+  fprintf(f, "{\"traceEvents\":[\n");
+  bool comma = false;
+  for(unsigned int i = 0; i < count; i++) {
+    const dc_ProfFrame* frame = &dc_prof.frames[(first + i) % DC_PROF_FRAMES];
+    fprintf(f, "%s{\"name\":\"frame %lu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}", comma ? ",\n" : "", first + i, (frame->start - dc_prof.epoch) * 1e6, frame->duration * 1e6);
+    comma = true;
+    for(unsigned int e = 0; e < frame->event_count; e++) {
+      const dc_ProfEvent* event = &frame->events[e];
+      fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}", dc_prof_phase_names[event->phase], (event->start - dc_prof.epoch) * 1e6, event->duration * 1e6);
+    }
+  }
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+  return fclose(f) == 0;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+// per-phase frame profiler. build with `make PROFILE=1` to turn it on, otherwise every
+// DC_PROF_* macro expands to nothing and none of this gets compiled in
+typedef enum {
+  DC_PHASE_INPUT,
+  DC_PHASE_AI,
+  DC_PHASE_UPDATE,
+  DC_PHASE_WALLS,
+  DC_PHASE_COLLISIONS,
+  DC_PHASE_FREE_PASS,
+  DC_PHASE_STAGE,
+  DC_PHASE_ROOM_DRAW,
+  DC_PHASE_ACTOR_DRAW,
+  DC_PHASE_HUD,
+  DC_PHASE_BLIT,
+  DC_PHASE_PRESENT,
+  DC_PHASE_COUNT
+} dc_Phase;
+
+#ifdef DC_PROFILE
+#include <stdbool.h>
+
+#define DC_PROF_FRAMES 256 // how much history the ring keeps
+#define DC_PROF_EVENTS_PER_FRAME 64 // past this a frame's extra events are dropped, totals still count
+
+// only the main thread records. the overlay and trace dump can read from anywhere: a frame is
+// published by bumping the ring's head once it's complete, and readers stay clear of the slot
+// that's being written
+void dc_prof_begin(dc_Phase phase);
+void dc_prof_end(dc_Phase phase);
+void dc_prof_frame(void);
+
+const char* dc_prof_phase_name(dc_Phase phase);
+// milliseconds per frame spent in a phase over the frames in the ring, p is 0..100. returns
+// how many frames went into it
+unsigned int dc_prof_percentile(dc_Phase phase, float p, float* ms);
+unsigned int dc_prof_frame_percentile(float p, float* ms);
+// every event in the ring in chrome's trace event format, loadable in about:tracing or perfetto
+bool dc_prof_write_trace(const char* path);
+
+#define DC_PROF_BEGIN(phase) dc_prof_begin(phase)
+#define DC_PROF_END(phase) dc_prof_end(phase)
+#define DC_PROF_FRAME() dc_prof_frame()
+
+#else
+
+#define DC_PROF_BEGIN(phase) ((void)0)
+#define DC_PROF_END(phase) ((void)0)
+#define DC_PROF_FRAME() ((void)0)
+
+#endif
@@ -0,0 +1,143 @@
+#include <string.h>
+#include <math.h>
+#include "replay.h"
+
+#define DC_INPUT_LOG_MAGIC "DCIN"
+#define DC_INPUT_LOG_VERSION 2
+#define DC_INPUT_RECORD_SIZE 10
+#define DC_INPUT_CHECK_SIZE 8
+// the byte in front of every entry
+#define DC_INPUT_TAG_STEP 'S'
+#define DC_INPUT_TAG_CHECK 'H'
+
+static int16_t dc_quantize_aim(float v) {
+  float q = roundf(v * DC_AIM_SCALE);
+  return q > INT16_MAX ? INT16_MAX : q < INT16_MIN ? INT16_MIN : (int16_t)q;
+}
+
+dc_InputRecord dc_InputRecord_create(uint8_t keys, uint8_t buttons, Vector2 aim, float dt) {
+  return (dc_InputRecord){keys, buttons, dc_quantize_aim(aim.x), dc_quantize_aim(aim.y), dt};
+}
+
+dc_Input dc_InputRecord_input(dc_InputRecord record) {
+  Vector2 move = {0};
+  if(record.keys & DC_KEY_LEFT) move.x -= 1;
+  if(record.keys & DC_KEY_RIGHT) move.x += 1;
+  if(record.keys & DC_KEY_UP) move.y -= 1;
+  if(record.keys & DC_KEY_DOWN) move.y += 1;
+  return (dc_Input){
+    .move = dc_get_vector_length(move) == 0 ? (Vector2){0} : dc_normalize_vector(move),
+    .aim = {record.aim_x / (float)DC_AIM_SCALE, record.aim_y / (float)DC_AIM_SCALE},
+    .slice = record.buttons & DC_BUTTON_SLICE
+  };
+}
+
+static void dc_put_u16(unsigned char* at, uint16_t v) {
+  at[0] = v;
+  at[1] = v >> 8;
+}
+
+static void dc_put_u32(unsigned char* at, uint32_t v) {
+  dc_put_u16(at, v);
+  dc_put_u16(at + 2, v >> 16);
+}
+
+static uint16_t dc_get_u16(const unsigned char* at) {
+  return at[0] | at[1] << 8;
+}
+
+static uint32_t dc_get_u32(const unsigned char* at) {
+  return dc_get_u16(at) | (uint32_t)dc_get_u16(at + 2) << 16;
+}
+
+// magic, version, seed, kernel set name
+#define DC_INPUT_LOG_HEADER_SIZE (4 + 4 + 8 + 16)
+
+bool dc_InputLog_create(dc_InputLog* log, const char* path, unsigned long long seed, const char* kernels) {
+  *log = (dc_InputLog){.seed = seed};
+  strncpy(log->kernels, kernels, sizeof(log->kernels) - 1);
+  log->file = fopen(path, "wb");
+  if(!log->file) return false;
+  unsigned char header[DC_INPUT_LOG_HEADER_SIZE] = {0};
+  memcpy(header, DC_INPUT_LOG_MAGIC, 4);
+  dc_put_u32(header + 4, DC_INPUT_LOG_VERSION);
+  dc_put_u32(header + 8, seed);
+  dc_put_u32(header + 12, seed >> 32);
+  memcpy(header + 16, log->kernels, sizeof(log->kernels));
+  fwrite(header, 1, sizeof(header), log->file);
+  return true;
+}
+
+void dc_InputLog_write(dc_InputLog* log, dc_InputRecord record) {
+  unsigned char bytes[1 + DC_INPUT_RECORD_SIZE];
+  uint32_t dt_bits;
+  memcpy(&dt_bits, &record.dt, sizeof(dt_bits));
+  bytes[0] = DC_INPUT_TAG_STEP;
+  bytes[1] = record.keys;
+  bytes[2] = record.buttons;
+  dc_put_u16(bytes + 3, (uint16_t)record.aim_x);
+  dc_put_u16(bytes + 5, (uint16_t)record.aim_y);
+  dc_put_u32(bytes + 7, dt_bits);
+  fwrite(bytes, 1, sizeof(bytes), log->file);
+  log->steps++;
+}
+
+void dc_InputLog_write_check(dc_InputLog* log, unsigned long long hash) {
+  if(log->steps == log->check_steps && log->steps > 0) return;
+  unsigned char bytes[1 + DC_INPUT_CHECK_SIZE];
+  bytes[0] = DC_INPUT_TAG_CHECK;
+  dc_put_u32(bytes + 1, hash);
+  dc_put_u32(bytes + 5, hash >> 32);
+  fwrite(bytes, 1, sizeof(bytes), log->file);
+  log->check = hash;
+  log->check_steps = log->steps;
+}
+
+bool dc_InputLog_open(dc_InputLog* log, const char* path) {
+  *log = (dc_InputLog){0};
+  log->file = fopen(path, "rb");
+  if(!log->file) {
+    fprintf(stderr, "can't open %s\n", path);
+    return false;
+  }
+  unsigned char header[DC_INPUT_LOG_HEADER_SIZE];
+  if(fread(header, 1, sizeof(header), log->file) != sizeof(header) || memcmp(header, DC_INPUT_LOG_MAGIC, 4) != 0 || dc_get_u32(header + 4) != DC_INPUT_LOG_VERSION) {
+    fprintf(stderr, "%s isn't a version %d input log\n", path, DC_INPUT_LOG_VERSION);
+    dc_InputLog_close(log);
+    return false;
+  }
+  log->seed = dc_get_u32(header + 8) | (unsigned long long)dc_get_u32(header + 12) << 32;
+  memcpy(log->kernels, header + 16, sizeof(log->kernels));
+  log->kernels[sizeof(log->kernels) - 1] = '\0';
+  return true;
+}
+
+dc_InputLogEntry dc_InputLog_read(dc_InputLog* log, dc_InputRecord* record) {
+  int tag = fgetc(log->file);
+  if(tag == DC_INPUT_TAG_CHECK) {
+    unsigned char bytes[DC_INPUT_CHECK_SIZE];
+    if(fread(bytes, 1, sizeof(bytes), log->file) != sizeof(bytes)) return DC_INPUT_LOG_END;
+    log->check = dc_get_u32(bytes) | (unsigned long long)dc_get_u32(bytes + 4) << 32;
+    log->check_steps = log->steps;
+    return DC_INPUT_LOG_CHECK;
+  }
+  unsigned char bytes[DC_INPUT_RECORD_SIZE];
+  if(tag != DC_INPUT_TAG_STEP || fread(bytes, 1, sizeof(bytes), log->file) != sizeof(bytes)) return DC_INPUT_LOG_END;
+  uint32_t dt_bits = dc_get_u32(bytes + 6);
+  record->keys = bytes[0];
+  record->buttons = bytes[1];
+  record->aim_x = (int16_t)dc_get_u16(bytes + 2);
+  record->aim_y = (int16_t)dc_get_u16(bytes + 4);
+  memcpy(&record->dt, &dt_bits, sizeof(record->dt));
+  log->steps++;
+  return DC_INPUT_LOG_STEP;
+}
+
+bool dc_InputLog_close(dc_InputLog* log) {
+  if(!log->file) return true;
+  // fwrite errors stick to the stream, so checking once here catches any of them
+  bool ok = !ferror(log->file);
+  if(fclose(log->file) != 0) ok = false;
+  log->file = NULL;
+  return ok;
+}
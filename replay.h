@@ -0,0 +1,53 @@
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include "sim.h"
+
+#define DC_KEY_UP 1
+#define DC_KEY_LEFT 2
+#define DC_KEY_DOWN 4
+#define DC_KEY_RIGHT 8
+#define DC_BUTTON_SLICE 1
+#define DC_AIM_SCALE 16 // aim is stored in 1/16ths of a virtual pixel
+#define DC_INPUT_LOG_CHECK_STEPS 600 // a world hash goes in the log every ten seconds of sim
+
+// one step's worth of raw input, which is everything the sim needs to redo that step. the live
+// game goes through this too, so a replay sees exactly the same numbers it did
+typedef struct {
+  uint8_t keys; // DC_KEY_*
+  uint8_t buttons; // DC_BUTTON_*, pressed this step
+  int16_t aim_x; // DC_AIM_SCALE fixed point, virtual SCREEN_WIDTH x SCREEN_HEIGHT space
+  int16_t aim_y;
+  float dt;
+} dc_InputRecord;
+
+dc_InputRecord dc_InputRecord_create(uint8_t keys, uint8_t buttons, Vector2 aim, float dt);
+dc_Input dc_InputRecord_input(dc_InputRecord record);
+
+typedef enum {
+  DC_INPUT_LOG_END,
+  DC_INPUT_LOG_STEP,
+  DC_INPUT_LOG_CHECK
+} dc_InputLogEntry;
+
+// a recorded session: a small header (seed, kernel set) then a tagged entry per step, little
+// endian. every so often and at the end there's a dc_World_hash of where the sim got to, so a
+// replay can prove it ended up in the same place instead of quietly drifting
+typedef struct {
+  FILE* file;
+  unsigned long long seed;
+  char kernels[16];
+  unsigned long steps;
+  unsigned long long check; // the last check read or written
+  unsigned long check_steps; // how many steps in it was
+} dc_InputLog;
+
+bool dc_InputLog_create(dc_InputLog* log, const char* path, unsigned long long seed, const char* kernels);
+void dc_InputLog_write(dc_InputLog* log, dc_InputRecord record);
+// the hash of the world after every step written so far. only one goes in per step
+void dc_InputLog_write_check(dc_InputLog* log, unsigned long long hash);
+bool dc_InputLog_open(dc_InputLog* log, const char* path);
+// DC_INPUT_LOG_CHECK leaves the hash the world should have right now in log->check
+dc_InputLogEntry dc_InputLog_read(dc_InputLog* log, dc_InputRecord* record);
+// false if any of what got written didn't make it out, a full disk say
+bool dc_InputLog_close(dc_InputLog* log);
@@ -0,0 +1,591 @@
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+#include "kernels.h"
+#include "jobs.h"
+#include "prof.h"
+
+#define BAT_SPEED 50
+// actors per chunk when a pass gets split across the job system. a normal room never gets
+// past one chunk, so it all runs inline without waking any threads
+#define SIM_GRAIN 1024
+#define COLLISION_GRAIN 256
+
+typedef struct {
+  dc_Actors* actors;
+  Vector2 target;
+  float dt;
+} dc_SimJob;
+
+typedef struct {
+  dc_Actors* actors;
+  const dc_FlowField* flow;
+  Vector2 target;
+} dc_AiJob;
+
+static void dc_ai_bats_job(void* ctx, unsigned int begin, unsigned int end, unsigned int worker) {
+  dc_AiJob* job = ctx;
+  dc_Actors* actors = job->actors;
+  const dc_FlowField* flow = job->flow;
+  // bats in iframes keep drifting with their knockback
+  dc_kernels.seek(actors->position + begin, actors->velocity + begin, actors->ai + begin, actors->iframe_time_remaining + begin, end - begin, job->target, BAT_SPEED);
+  // straight at the player is right from anywhere that can see them, everyone else follows the field
+  for(unsigned int a = begin; a < end; a++) {
+    if(actors->ai[a] != DC_AI_BAT || actors->iframe_time_remaining[a] > 0) continue;
+    int col, row;
+    if(!dc_RoomGrid_cell(actors->position[a], &col, &row)) continue;
+    if(flow->direct[row][col] || flow->distance[row][col] == DC_FLOW_UNREACHED) continue;
+    Vector2 dir = flow->direction[row][col];
+    actors->velocity[a] = (Vector2){dir.x * BAT_SPEED, dir.y * BAT_SPEED};
+  }
+}
+
+void dc_ai_bats(dc_Actors* actors, const dc_FlowField* flow, Vector2 player_position) {
+  dc_AiJob job = {actors, flow, player_position};
+  dc_jobs_parallel_for(actors->count, SIM_GRAIN, dc_ai_bats_job, &job);
+}
+
+static void dc_Actors_update_job(void* ctx, unsigned int begin, unsigned int end, unsigned int worker) {
+  dc_SimJob* job = ctx;
+  dc_Actors* actors = job->actors;
+  float dt = job->dt;
+  dc_kernels.tick_timers(actors->time_until_next_frame + begin, actors->iframe_time_remaining + begin, end - begin, dt);
+
+  // update frames/anims. only a handful of actors roll over on any given step
+  for(unsigned int a = begin; a < end; a++) {
+    if(actors->time_until_next_frame[a] > 0) continue;
+    dc_Anim* anim = &actors->anim[a];
+    if(anim->current_frame+1 >= anim->frame_count) {
+      anim->current_frame = 0;
+      if(anim->free_on_anim_comp) actors->should_be_freed[a] = true;
+    } else {
+      anim->current_frame++;
+    }
+    actors->time_until_next_frame[a] += anim->time_per_frame;
+  }
+
+  // update position based on velocity
+  dc_kernels.integrate(actors->position + begin, actors->velocity + begin, end - begin, dt);
+}
+
+void dc_Actors_update(dc_Actors* actors, float dt) {
+  dc_SimJob job = {actors, {0}, dt};
+  dc_jobs_parallel_for(actors->count, SIM_GRAIN, dc_Actors_update_job, &job);
+}
+
+dc_Actor dc_Actor_create_bat(dc_Frames* frame_data, Vector2 pos) {
+  dc_Actor bat = {0};
+  bat.sprite.frames = DC_FRAMES_DWARF;
+  bat.sprite.color = WHITE;
+  bat.sprite.rotation = 0.f;
+  bat.position = pos;
+  bat.velocity = (Vector2){0};
+  bat.sprite.origin = (Vector2){11, 17};
+  bat.anim.time_per_frame = 0.5f;
+  bat.time_until_next_frame = 0.5f;
+  bat.anim.current_frame = 0;
+  bat.sprite.has_shadow = true;
+  bat.sprite.shadow_offset = (Vector2){0, TILE_HEIGHT * 0.3};
+  bat.anim.frame_count = frame_data->counts[DC_FRAMES_DWARF];
+  bat.anim.free_on_anim_comp = false;
+  bat.collider.layer = COL_LAYER_ENEMY;
+  bat.collider.mask = COL_LAYER_PLAYER;
+  bat.collider.damage = 1;
+  bat.iframe_time_remaining = 0;
+  bat.health.hp = 3;
+  bat.health.hp_max = 3;
+  bat.ai = DC_AI_BAT;
+
+  return bat;
+}
+
+dc_Actor dc_Actor_create_player(dc_Frames* frame_data) {
+  dc_Actor player = {0};
+  player.sprite.frames = DC_FRAMES_SKELETON;
+  player.sprite.color = WHITE;
+  player.sprite.rotation = 0.f;
+  player.position = (Vector2){100, 100};
+  player.sprite.origin = (Vector2){10, 13};
+  player.velocity = (Vector2){0};
+  player.anim.time_per_frame = 0.5f;
+  player.time_until_next_frame = 0.5f;
+  player.anim.current_frame = 0;
+  player.sprite.has_shadow = true;
+  player.sprite.shadow_offset = (Vector2){1, TILE_HEIGHT * 0.475};
+  player.anim.frame_count = frame_data->counts[DC_FRAMES_SKELETON];
+  player.anim.free_on_anim_comp = false;
+  player.collider.layer = COL_LAYER_PLAYER;
+  player.collider.mask = 0;
+  player.collider.damage = 0;
+  player.iframe_time_remaining = 0;
+  player.health.hp = 6;
+  player.health.hp_max = 6;
+  player.ai = DC_AI_NONE;
+
+  return player;
+}
+
+bool dc_Actor_touches(const dc_Actors* actors, unsigned int us, unsigned int them) {
+  if(us == them) return false;
+  if(!(actors->collider[us].mask & actors->collider[them].layer)) return false;
+  return CheckCollisionCircles(actors->position[us], TILE_WIDTH/2.f, actors->position[them], TILE_WIDTH/2.f);
+}
+
+// them loses damage hp and gets knocked away from `from`
+static void dc_Actor_take_hit(dc_Actors* actors, unsigned int them, Vector2 from, int damage) {
+  dc_Health* them_health = &actors->health[them];
+  them_health->hp -= damage;
+  Vector2 v = dc_kernels.direction(from, actors->position[them]);
+  v.x *= 20;
+  v.y *= 20;
+  actors->velocity[them] = v;
+  if(them_health->hp <= 0) {
+    actors->should_be_freed[them] = true;
+  } else actors->iframe_time_remaining[them] = IFRAME_DURATION;
+}
+
+void dc_Actor_hit(dc_Actors* actors, unsigned int us, unsigned int them) {
+  if(actors->iframe_time_remaining[us] > 0 || actors->iframe_time_remaining[them] > 0) return;
+  dc_Actor_take_hit(actors, them, actors->position[us], actors->collider[us].damage);
+}
+
+void dc_Actor_collide(dc_Actors* actors, unsigned int us, unsigned int them) {
+  if(dc_Actor_touches(actors, us, them)) dc_Actor_hit(actors, us, them);
+}
+
+typedef struct {
+  dc_Broadphase* bp;
+  dc_Actors* actors;
+} dc_CollisionJob;
+
+// positions and colliders don't change during the collision pass, so finding who touches who
+// can run on any thread. each chunk writes its (us, them) pairs into its own list
+static void dc_collision_gather_job(void* ctx, unsigned int begin, unsigned int end, unsigned int worker) {
+  dc_CollisionJob* job = ctx;
+  dc_Actors* actors = job->actors;
+  dc_IndexList* candidates = &job->bp->worker_scratch[worker];
+  dc_IndexList* pairs = &job->bp->chunk_pairs[begin / COLLISION_GRAIN];
+  pairs->count = 0;
+  for(unsigned int us = begin; us < end; us++) {
+    if(actors->collider[us].mask == 0) continue;
+    dc_Broadphase_query(job->bp, actors->position[us], actors->collider[us].mask, candidates);
+    for(unsigned int t = 0; t < candidates->count; t++) {
+      unsigned int them = candidates->items[t];
+      if(!dc_Actor_touches(actors, us, them)) continue;
+      dc_IndexList_push(pairs, us);
+      dc_IndexList_push(pairs, them);
+    }
+  }
+}
+
+void dc_Actors_handle_collisions(dc_Broadphase* bp, dc_Actors* actors) {
+  dc_Broadphase_build(bp, actors->position, actors->collider, actors->count);
+  unsigned int chunks = dc_jobs_chunk_count(actors->count, COLLISION_GRAIN);
+  dc_Broadphase_reserve_lists(bp, dc_jobs_worker_count(), chunks);
+  dc_CollisionJob job = {bp, actors};
+  dc_jobs_parallel_for(actors->count, COLLISION_GRAIN, dc_collision_gather_job, &job);
+
+  // hits depend on iframes handed out by earlier hits, so they're applied on this thread in
+  // chunk order, which is the same (us, them) order the old nested loop used
+  for(unsigned int c = 0; c < chunks; c++) {
+    const dc_IndexList* pairs = &bp->chunk_pairs[c];
+    for(unsigned int p = 0; p < pairs->count; p += 2) {
+      dc_Actor_hit(actors, pairs->items[p], pairs->items[p + 1]);
+    }
+  }
+}
+
+// effects never go in the broadphase, the ones that hurt just look up who they're touching once
+// the actors have had their turn. a circle the same size as an actor's
+void dc_Effects_handle_collisions(dc_Broadphase* bp, const dc_Effects* effects, dc_Actors* actors) {
+  if(effects->count == 0) return;
+  dc_Broadphase_reserve_lists(bp, 1, 0);
+  dc_IndexList* candidates = &bp->worker_scratch[0];
+  for(unsigned int i = 0; i < effects->count; i++) {
+    const dc_Effect* e = dc_Effects_at_const(effects, i);
+    const dc_EffectInfo* info = &dc_effect_info[e->kind];
+    if(info->damage == 0) continue;
+    dc_Broadphase_query(bp, e->position, info->mask, candidates);
+    for(unsigned int t = 0; t < candidates->count; t++) {
+      unsigned int them = candidates->items[t];
+      // already killed by the actor pairs this step, it's gone come the free pass
+      if(actors->should_be_freed[them] || actors->iframe_time_remaining[them] > 0) continue;
+      if(!CheckCollisionCircles(e->position, TILE_WIDTH/2.f, actors->position[them], TILE_WIDTH/2.f)) continue;
+      dc_Actor_take_hit(actors, them, e->position, info->damage);
+    }
+  }
+}
+
+void dc_Actors_handle_collisions_naive(dc_Actors* actors) {
+  for(unsigned int us = 0; us < actors->count; us++) {
+    for(unsigned int them = 0; them < actors->count; them++) {
+      dc_Actor_collide(actors, us, them);
+    }
+  }
+}
+
+dc_Room dc_Room_generate(unsigned long long seed, unsigned int x, unsigned int y, unsigned int rooms_cleared) {
+  // every coordinate gets its own stream off the seed
+  dc_Rng rng;
+  dc_Rng_seed(&rng, seed * 0x9E3779B97F4A7C15ull ^ ((unsigned long long)y << 32 | x));
+  dc_Room room = {0};
+
+  if(x == FLOOR_START_X && y == FLOOR_START_Y) {
+    // only the one way out of the first room
+    static const unsigned char start_doors[] = {DC_DOOR_NORTH, DC_DOOR_WEST, DC_DOOR_EAST, DC_DOOR_SOUTH};
+    room.doors = start_doors[dc_Rng_below(&rng, 4)];
+    room.remaining_monsters = 1;
+    return room;
+  }
+
+  // every side that doesn't run off the floor, which always includes the way we came in
+  if(x != 0) room.doors |= DC_DOOR_WEST;
+  if(x != FLOOR_WIDTH - 1) room.doors |= DC_DOOR_EAST;
+  if(y != FLOOR_HEIGHT - 1) room.doors |= DC_DOOR_SOUTH;
+  if(y != 0) room.doors |= DC_DOOR_NORTH;
+
+  if(rooms_cleared < ROOMS_TO_WIN) room.remaining_monsters = 1 + dc_Rng_below(&rng, 4);
+  return room;
+}
+
+static const Vector2 dc_spawn_points[DC_MAX_ROOM_BATS] = {{50, 50}, {250, 50}, {50, 250}, {250, 250}};
+
+void dc_World_init(dc_World* world, dc_Frames* frame_data, unsigned long long seed) {
+  *world = (dc_World){0};
+  world->frame_data = frame_data;
+  world->seed = seed;
+  world->grids = malloc(sizeof(dc_RoomGrid) * DC_ROOM_LAYOUTS);
+  for(unsigned int doors = 0; doors < DC_ROOM_LAYOUTS; doors++) {
+    dc_RoomGrid_build(&world->grids[doors], doors);
+  }
+  world->flow = calloc(1, sizeof(dc_FlowField));
+
+  // sized so everything inside DC_FLOOR_KEEP_RADIUS fits without the table ever growing
+  static const unsigned int kept = (2 * DC_FLOOR_KEEP_RADIUS + 1) * (2 * DC_FLOOR_KEEP_RADIUS + 1);
+  dc_Floor_init(&world->floor, kept * 4 / 3 + 1);
+  world->room_x = FLOOR_START_X;
+  world->room_y = FLOOR_START_Y;
+  dc_Floor_insert(&world->floor, world->room_x, world->room_y, dc_Room_generate(seed, world->room_x, world->room_y, 0));
+
+  dc_Actors_init(&world->actors, INITIAL_ACTORS);
+  world->player = dc_Actors_add(&world->actors, dc_Actor_create_player(frame_data));
+  dc_Actors_add(&world->actors, dc_Actor_create_bat(frame_data, (Vector2){250, 250}));
+}
+
+void dc_World_free(dc_World* world) {
+  dc_Floor_free(&world->floor);
+  free(world->grids);
+  world->grids = NULL;
+  free(world->flow);
+  world->flow = NULL;
+
+  dc_Actors_free(&world->actors);
+  world->player = DC_HANDLE_NULL;
+  dc_Broadphase_free(&world->broadphase);
+}
+
+int dc_World_player(const dc_World* world) {
+  return dc_Actors_index(&world->actors, world->player);
+}
+
+dc_Room* dc_World_room(const dc_World* world) {
+  return dc_Floor_find(&world->floor, world->room_x, world->room_y);
+}
+
+static unsigned long long dc_hash_bytes(unsigned long long h, const void* data, size_t len) {
+  const unsigned char* bytes = data;
+  for(size_t i = 0; i < len; i++) {
+    h ^= bytes[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+unsigned long long dc_World_hash(const dc_World* world) {
+  const dc_Actors* actors = &world->actors;
+  unsigned long long h = 14695981039346656037ull;
+  h = dc_hash_bytes(h, &actors->count, sizeof(actors->count));
+  h = dc_hash_bytes(h, actors->position, sizeof(Vector2) * actors->count);
+  h = dc_hash_bytes(h, actors->velocity, sizeof(Vector2) * actors->count);
+  h = dc_hash_bytes(h, actors->time_until_next_frame, sizeof(float) * actors->count);
+  h = dc_hash_bytes(h, actors->iframe_time_remaining, sizeof(float) * actors->count);
+  h = dc_hash_bytes(h, actors->health, sizeof(dc_Health) * actors->count);
+  h = dc_hash_bytes(h, actors->ai, sizeof(dc_AiKind) * actors->count);
+  // field by field so struct padding doesn't end up in the hash
+  for(unsigned int a = 0; a < actors->count; a++) {
+    h = dc_hash_bytes(h, &actors->anim[a].current_frame, sizeof(actors->anim[a].current_frame));
+    h = dc_hash_bytes(h, &actors->collider[a].layer, sizeof(actors->collider[a].layer));
+    h = dc_hash_bytes(h, &actors->collider[a].mask, sizeof(actors->collider[a].mask));
+    h = dc_hash_bytes(h, &actors->collider[a].damage, sizeof(actors->collider[a].damage));
+  }
+  h = dc_hash_bytes(h, &world->effects.count, sizeof(world->effects.count));
+  for(unsigned int i = 0; i < world->effects.count; i++) {
+    const dc_Effect* e = dc_Effects_at_const(&world->effects, i);
+    h = dc_hash_bytes(h, &e->position, sizeof(e->position));
+    h = dc_hash_bytes(h, &e->rotation, sizeof(e->rotation));
+    h = dc_hash_bytes(h, &e->time_until_next_frame, sizeof(e->time_until_next_frame));
+    h = dc_hash_bytes(h, &e->kind, sizeof(e->kind));
+    h = dc_hash_bytes(h, &e->frame, sizeof(e->frame));
+  }
+  h = dc_hash_bytes(h, &world->room_x, sizeof(world->room_x));
+  h = dc_hash_bytes(h, &world->room_y, sizeof(world->room_y));
+  h = dc_hash_bytes(h, &world->rooms_cleared, sizeof(world->rooms_cleared));
+  h = dc_hash_bytes(h, world->floor.cleared, sizeof(uint32_t) * world->floor.cleared_count);
+  return h;
+}
+
+// gets the room behind door (1 << d) ready to walk into
+static void dc_sim_stage_room(dc_World* world, unsigned int d) {
+  static const int offsets[4][2] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}};
+  dc_StagedRoom* staged = &world->staged[d];
+  staged->x = world->room_x + offsets[d][0];
+  staged->y = world->room_y + offsets[d][1];
+  staged->won = world->rooms_cleared >= ROOMS_TO_WIN;
+  // nothing touches a room we're not in, so what's on the floor now is what we'll walk into
+  const dc_Room* known = dc_Floor_find(&world->floor, staged->x, staged->y);
+  staged->generated = known == NULL;
+  staged->room = known ? *known : dc_Room_generate(world->seed, staged->x, staged->y, world->rooms_cleared);
+  // a room that got evicted after it was cleared stays cleared, it doesn't fill back up with
+  // bats and it can't count toward rooms_cleared twice
+  if(!known && dc_Floor_was_cleared(&world->floor, staged->x, staged->y)) {
+    staged->room.remaining_monsters = 0;
+    staged->room.doors_opened = true;
+  }
+  staged->bat_count = staged->room.remaining_monsters;
+  for(unsigned int b = 0; b < staged->bat_count; b++) {
+    staged->bats[b] = dc_Actor_create_bat(world->frame_data, dc_spawn_points[b]);
+  }
+  staged->ready = true;
+}
+
+// a little of the next room's work every step. first the rooms we've walked away from get
+// forgotten, so the floor never holds more than a screenful of them, then one neighbour a step.
+// the actor arrays also keep room for a room's bats, so a door never grows them
+static void dc_sim_stage_ahead(dc_World* world) {
+  dc_Actors* actors = &world->actors;
+  if(actors->count + DC_MAX_ROOM_BATS > actors->capacity) dc_Actors_reserve(actors, actors->capacity * 2);
+  if(world->evict_pending) {
+    dc_Floor_evict_far(&world->floor, world->room_x, world->room_y, DC_FLOOR_KEEP_RADIUS);
+    world->evict_pending = false;
+    return;
+  }
+
+  const dc_Room* room = dc_World_room(world);
+  bool won = world->rooms_cleared >= ROOMS_TO_WIN;
+  for(unsigned int d = 0; d < 4; d++) {
+    if(!(room->doors & (1 << d))) continue;
+    if(world->staged[d].ready && world->staged[d].won == won) continue;
+    dc_sim_stage_room(world, d);
+    return;
+  }
+}
+
+// moves the player through door (1 << d) and lets the bats in
+static void dc_sim_enter_room(dc_World* world, unsigned int d) {
+  dc_StagedRoom* staged = &world->staged[d];
+  // only if the door gets used within a few steps of arriving
+  if(!staged->ready || staged->won != (world->rooms_cleared >= ROOMS_TO_WIN)) dc_sim_stage_room(world, d);
+
+  world->room_x = staged->x;
+  world->room_y = staged->y;
+  if(staged->generated) dc_Floor_insert(&world->floor, staged->x, staged->y, staged->room);
+  for(unsigned int b = 0; b < staged->bat_count; b++) {
+    dc_Actors_add(&world->actors, staged->bats[b]);
+  }
+  for(unsigned int n = 0; n < 4; n++) {
+    world->staged[n].ready = false;
+  }
+  world->evict_pending = true;
+  world->events |= DC_EVENT_ROOM_CHANGED;
+}
+
+typedef struct {
+  dc_Actors* actors;
+  const dc_RoomGrid* grid;
+  int player;
+  unsigned char player_allowed; // DC_CELL_* the player can stand in
+  float dt;
+} dc_WallsJob;
+
+// anyone who ended up in a cell they're not allowed in backs out along the axis that took them
+// there, so they slide along the wall. if neither does it (spawned in a wall, knocked through a
+// corner) they get put back on the floor
+static void dc_walls_job(void* ctx, unsigned int begin, unsigned int end, unsigned int worker) {
+  dc_WallsJob* job = ctx;
+  dc_Actors* actors = job->actors;
+  const dc_RoomGrid* grid = job->grid;
+  for(unsigned int a = begin; a < end; a++) {
+    unsigned char allowed = (int)a == job->player ? job->player_allowed : DC_CELL_FLOOR;
+    Vector2* p = &actors->position[a];
+    if(dc_RoomGrid_at(grid, *p) & allowed) continue;
+    Vector2 from = {p->x - actors->velocity[a].x * job->dt, p->y - actors->velocity[a].y * job->dt};
+    if(dc_RoomGrid_at(grid, (Vector2){p->x, from.y}) & allowed) p->y = from.y;
+    else if(dc_RoomGrid_at(grid, (Vector2){from.x, p->y}) & allowed) p->x = from.x;
+    else {
+      p->x = dc_clampf(p->x, grid->floor_min_x, grid->floor_max_x);
+      p->y = dc_clampf(p->y, grid->floor_min_y, grid->floor_max_y);
+    }
+  }
+}
+
+// keeps everyone out of the walls, and once the doors are open lets the player through them.
+// door triggers come out of the same grid, so it's a lookup or two an actor whatever's going on
+static void dc_sim_walls(dc_World* world, int player, float dt) {
+  const dc_Room* room = dc_World_room(world);
+  bool open = room->doors_opened;
+  dc_WallsJob job = {&world->actors, &world->grids[room->doors], player, open ? DC_CELL_FLOOR | DC_CELL_DOORWAY | DC_CELL_DOOR : DC_CELL_FLOOR, dt};
+  dc_jobs_parallel_for(world->actors.count, SIM_GRAIN, dc_walls_job, &job);
+  if(player < 0 || !open) return;
+
+  // entering a room can grow the actor arrays, so the player's moved before that happens
+  Vector2* position = &world->actors.position[player];
+  unsigned char cell = dc_RoomGrid_at(job.grid, *position);
+  if(!(cell & DC_CELL_DOOR)) return;
+  unsigned int side = cell >> DC_CELL_SIDE_SHIFT;
+  if(side == 0) position->y = TILE_HEIGHT * 3;
+  else if(side == 1) position->y = TILE_HEIGHT * 5;
+  else if(side == 2) position->x = TILE_WIDTH * 2;
+  else position->x = TILE_WIDTH * 18;
+  dc_sim_enter_room(world, side);
+}
+
+// swap-removes everything flagged this step. walks backwards so whatever gets swapped
+// into a hole has already been looked at
+static void dc_sim_free_pass(dc_World* world) {
+  dc_Actors* actors = &world->actors;
+  for(int a = (int)actors->count - 1; a >= 0; a--) {
+    if(!actors->should_be_freed[a]) continue;
+    if(actors->ai[a] != DC_AI_NONE) {
+      dc_Room* room = dc_World_room(world);
+      room->remaining_monsters--;
+      if(room->remaining_monsters == 0 && !room->doors_opened) {
+        world->events |= DC_EVENT_DOORS_OPENED;
+        room->doors_opened = true;
+        world->rooms_cleared++;
+        dc_Floor_mark_cleared(&world->floor, world->room_x, world->room_y);
+      }
+    }
+    dc_Actors_swap_remove(actors, a);
+  }
+}
+
+void dc_sim_step(dc_World* world, dc_Input input, float dt) {
+  dc_Actors* actors = &world->actors;
+  world->events = 0;
+
+  int player = dc_World_player(world);
+  if(player >= 0) {
+    DC_PROF_BEGIN(DC_PHASE_INPUT);
+    Vector2 player_position = actors->position[player];
+    actors->velocity[player] = (Vector2){input.move.x * 100, input.move.y * 100};
+    if(input.slice) {
+      Vector2 dir = dc_kernels.direction(player_position, input.aim);
+      static const int slice_distance = 12;
+      Vector2 slice_pos = (Vector2){player_position.x + slice_distance * dir.x, player_position.y + slice_distance * dir.y};
+      // the sprite still wants an angle, but that's one atan2 per click
+      dc_Effects_add(&world->effects, DC_EFFECT_SLICE, slice_pos, atan2(dir.y, dir.x) * RAD2DEG + 135);
+    }
+    DC_PROF_END(DC_PHASE_INPUT);
+
+    DC_PROF_BEGIN(DC_PHASE_AI);
+    // only does anything when the player's moved to another cell or room
+    dc_FlowField_update(world->flow, &world->grids[dc_World_room(world)->doors], player_position);
+    dc_ai_bats(actors, world->flow, player_position);
+    DC_PROF_END(DC_PHASE_AI);
+  }
+
+  DC_PROF_BEGIN(DC_PHASE_UPDATE);
+  dc_Actors_update(actors, dt);
+  dc_Effects_update(&world->effects, world->frame_data, dt);
+  DC_PROF_END(DC_PHASE_UPDATE);
+
+  DC_PROF_BEGIN(DC_PHASE_WALLS);
+  dc_sim_walls(world, player, dt);
+  DC_PROF_END(DC_PHASE_WALLS);
+
+  // one pass is enough: the old once-per-actor repeats only ever re-hit things that were already dead
+  DC_PROF_BEGIN(DC_PHASE_COLLISIONS);
+  dc_Actors_handle_collisions(&world->broadphase, actors);
+  dc_Effects_handle_collisions(&world->broadphase, &world->effects, actors);
+  DC_PROF_END(DC_PHASE_COLLISIONS);
+
+  DC_PROF_BEGIN(DC_PHASE_FREE_PASS);
+  dc_sim_free_pass(world);
+  dc_Effects_remove_done(&world->effects);
+  DC_PROF_END(DC_PHASE_FREE_PASS);
+
+  DC_PROF_BEGIN(DC_PHASE_STAGE);
+  dc_sim_stage_ahead(world);
+  DC_PROF_END(DC_PHASE_STAGE);
+}
+
+dc_Input dc_sim_scripted_input(const dc_World* world, unsigned long step) {
+  dc_Input input = {0};
+  int player = dc_World_player(world);
+  if(player < 0) return input;
+  const dc_Actors* actors = &world->actors;
+  Vector2 player_position = actors->position[player];
+
+  int target = -1;
+  float best = INFINITY;
+  for(unsigned int a = 0; a < actors->count; a++) {
+    if(actors->ai[a] == DC_AI_NONE) continue;
+    float dx = actors->position[a].x - player_position.x;
+    float dy = actors->position[a].y - player_position.y;
+    if(dx * dx + dy * dy < best) {
+      best = dx * dx + dy * dy;
+      target = a;
+    }
+  }
+
+  if(target >= 0) {
+    // stay just out of reach and keep swinging
+    Vector2 target_position = actors->position[target];
+    if(best > 24 * 24) input.move = dc_get_direction_to(player_position, target_position);
+    else input.move = dc_get_direction_to(target_position, player_position);
+    input.aim = target_position;
+    input.slice = step % 8 == 0;
+    return input;
+  }
+
+  const dc_Room* room = dc_World_room(world);
+  if(!room->doors_opened) return input;
+
+  // line up in front of a door, then walk straight through it so the wall hitboxes don't catch us.
+  // prefer doors that lead somewhere we haven't been yet
+  unsigned int x = world->room_x;
+  unsigned int y = world->room_y;
+  struct { bool open; unsigned int next_x, next_y; Vector2 front; Vector2 through; } doors[4] = {
+    {room->doors & DC_DOOR_NORTH, x, y - 1, {TILE_WIDTH * 10, TILE_HEIGHT * 3.5}, {TILE_WIDTH * 10, TILE_HEIGHT * 2}},
+    {room->doors & DC_DOOR_SOUTH, x, y + 1, {TILE_WIDTH * 9, TILE_HEIGHT * 4.5}, {TILE_WIDTH * 9, TILE_HEIGHT * 6.5}},
+    {room->doors & DC_DOOR_WEST, x - 1, y, {TILE_WIDTH * 3, TILE_HEIGHT * 4.5}, {TILE_WIDTH * 1, TILE_HEIGHT * 4.5}},
+    {room->doors & DC_DOOR_EAST, x + 1, y, {TILE_WIDTH * 17, TILE_HEIGHT * 4.5}, {TILE_WIDTH * 19, TILE_HEIGHT * 4.5}},
+  };
+  doors[0].open = doors[0].open && y > 0;
+  doors[1].open = doors[1].open && y < FLOOR_HEIGHT - 1;
+  doors[2].open = doors[2].open && x > 0;
+  doors[3].open = doors[3].open && x < FLOOR_WIDTH - 1;
+
+  int pick = -1;
+  for(int d = 0; d < 4; d++) {
+    if(doors[d].open && dc_Floor_find(&world->floor, doors[d].next_x, doors[d].next_y) == NULL) {
+      pick = d;
+      break;
+    }
+  }
+  if(pick < 0) {
+    for(int d = 0, offset = (step / 600) % 4; d < 4; d++) {
+      if(doors[(d + offset) % 4].open) {
+        pick = (d + offset) % 4;
+        break;
+      }
+    }
+  }
+  if(pick < 0) return input;
+
+  Vector2 front = doors[pick].front;
+  bool lined_up = pick < 2 ? fabsf(player_position.x - front.x) < 2 : fabsf(player_position.y - front.y) < 2;
+  if(lined_up) input.move = dc_get_direction_to(player_position, doors[pick].through);
+  else input.move = dc_get_direction_to(player_position, front);
+  return input;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "dc.h"
+#include "actors.h"
+#include "broadphase.h"
+#include "floor.h"
+#include "walls.h"
+#include "flow.h"
+#include "effects.h"
+
+// things that happened during a step that the presentation side cares about
+#define DC_EVENT_DOORS_OPENED 1 // 0b01
+#define DC_EVENT_ROOM_CHANGED 2 // 0b10
+
+#define DC_ROOM_LAYOUTS 16 // every combination of DC_DOOR_* bits
+#define DC_MAX_ROOM_BATS 4 // dc_Room_generate never asks for more
+
+// the room behind one of the current room's doors, generated and with its bats already built
+// while we're still in here, so walking through the door only has to copy it in
+typedef struct {
+  bool ready;
+  bool won; // rooms come out empty once the game's won, so a stage from before that is stale
+  bool generated; // false if it was already on the floor and only needs its bats
+  unsigned int x;
+  unsigned int y;
+  dc_Room room;
+  unsigned int bat_count;
+  dc_Actor bats[DC_MAX_ROOM_BATS];
+} dc_StagedRoom;
+
+typedef struct {
+  Vector2 move; // already normalized, the sim scales it by the player speed
+  Vector2 aim;  // in virtual SCREEN_WIDTH x SCREEN_HEIGHT space
+  bool slice;
+} dc_Input;
+
+// the entire game state; nothing in here touches the window, gpu or audio device
+typedef struct {
+  dc_Frames* frame_data;
+  dc_Actors actors;
+  dc_Effects effects; // slices and the like, they don't take up actor slots
+  dc_Handle player; // goes stale once the player is dead
+  dc_Floor floor;
+  dc_RoomGrid* grids; // DC_ROOM_LAYOUTS of them, a room's doors pick its grid
+  dc_FlowField* flow; // toward the player over the current room's grid. derived, never saved
+  unsigned int room_x;
+  unsigned int room_y;
+  unsigned int rooms_cleared;
+  unsigned int events; // DC_EVENT_* raised by the last dc_sim_step
+  dc_Broadphase broadphase;
+  dc_StagedRoom staged[4]; // one per door, in DC_DOOR_* bit order
+  bool evict_pending; // the floor still has the rooms we walked away from last time
+  unsigned long long seed; // the whole dungeon comes out of this, see dc_Room_generate
+} dc_World;
+
+void dc_ai_bats(dc_Actors* actors, const dc_FlowField* flow, Vector2 player_position);
+void dc_Actors_update(dc_Actors* actors, float dt);
+dc_Actor dc_Actor_create_bat(dc_Frames* frame_data, Vector2 pos);
+dc_Actor dc_Actor_create_player(dc_Frames* frame_data);
+// whether us's collision mask hits them and they overlap. only reads positions and colliders
+bool dc_Actor_touches(const dc_Actors* actors, unsigned int us, unsigned int them);
+// damage and knockback from `us` onto `them` unless either is in iframes
+void dc_Actor_hit(dc_Actors* actors, unsigned int us, unsigned int them);
+void dc_Actor_collide(dc_Actors* actors, unsigned int us, unsigned int them);
+// every pair resolved in (us, them) index order, same as the naive version but only testing
+// broadphase neighbours. finding the pairs is spread over the job system
+void dc_Actors_handle_collisions(dc_Broadphase* bp, dc_Actors* actors);
+void dc_Actors_handle_collisions_naive(dc_Actors* actors);
+// the hurting effects against whatever's in their mask, off the broadphase the actors just built
+void dc_Effects_handle_collisions(dc_Broadphase* bp, const dc_Effects* effects, dc_Actors* actors);
+// the room at (x, y) only depends on the seed and the coordinate, so an evicted room comes back
+// exactly as it was first made. once the game's won they come back empty
+dc_Room dc_Room_generate(unsigned long long seed, unsigned int x, unsigned int y, unsigned int rooms_cleared);
+
+void dc_World_init(dc_World* world, dc_Frames* frame_data, unsigned long long seed);
+void dc_World_free(dc_World* world);
+// dense index of the player in world->actors, -1 once it's dead
+int dc_World_player(const dc_World* world);
+// the room the player's in, which is never evicted
+dc_Room* dc_World_room(const dc_World* world);
+// FNV-1a over every bit of sim state, for checking two runs ended up in the same place
+unsigned long long dc_World_hash(const dc_World* world);
+void dc_sim_step(dc_World* world, dc_Input input, float dt);
+
+// deterministic stand-in for a player: chases the nearest enemy, slices at it,
+// and walks through an open door once the room is clear
+dc_Input dc_sim_scripted_input(const dc_World* world, unsigned long step);
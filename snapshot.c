@@ -0,0 +1,285 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include "snapshot.h"
+
+typedef struct {
+  char magic[4]; // "DCSS"
+  uint32_t version;
+  uint32_t size; // header included
+  uint32_t actor_count;
+  uint64_t seed;
+  uint16_t record_sizes[9]; // see dc_snapshot_record_sizes
+  uint32_t actor_capacity; // handles index slots, so all of those come along
+  uint32_t free_slot;
+  uint32_t player_slot;
+  uint32_t player_generation;
+  uint32_t room_x;
+  uint32_t room_y;
+  uint32_t rooms_cleared;
+  uint32_t events;
+  uint32_t evict_pending;
+  uint32_t floor_capacity;
+  uint32_t floor_count;
+  uint32_t effect_count; // oldest first
+  uint32_t cleared_count;
+} dc_SnapshotHeader;
+
+static void dc_snapshot_record_sizes(uint16_t sizes[9]) {
+  sizes[0] = sizeof(dc_ActorSlot);
+  sizes[1] = sizeof(dc_Anim);
+  sizes[2] = sizeof(dc_Health);
+  sizes[3] = sizeof(dc_Collider);
+  sizes[4] = sizeof(dc_AiKind);
+  sizes[5] = sizeof(bool);
+  sizes[6] = sizeof(dc_Sprite);
+  sizes[7] = sizeof(dc_Room);
+  sizes[8] = sizeof(dc_Effect);
+}
+
+// bytes per actor across every component array
+static size_t dc_snapshot_actor_size(void) {
+  return sizeof(unsigned int) + sizeof(Vector2) * 2 + sizeof(float) * 2 + sizeof(dc_Anim) + sizeof(dc_Health) +
+         sizeof(dc_Collider) + sizeof(dc_AiKind) + sizeof(bool) + sizeof(dc_Sprite);
+}
+
+static size_t dc_snapshot_expected_size(unsigned int actor_count, unsigned int actor_capacity, unsigned int floor_capacity, unsigned int cleared_count, unsigned int effect_count) {
+  return sizeof(dc_SnapshotHeader) + sizeof(dc_ActorSlot) * (size_t)actor_capacity + dc_snapshot_actor_size() * actor_count +
+         (sizeof(uint32_t) + sizeof(dc_Room)) * (size_t)floor_capacity + sizeof(uint32_t) * (size_t)cleared_count +
+         sizeof(dc_Effect) * (size_t)effect_count;
+}
+
+size_t dc_snapshot_size(const dc_World* world) {
+  return dc_snapshot_expected_size(world->actors.count, world->actors.capacity, world->floor.capacity, world->floor.cleared_count, world->effects.count);
+}
+
+#define DC_PUT(src, bytes) do { memcpy(at, (src), (bytes)); at += (bytes); } while(0)
+#define DC_GET(dst, bytes) do { memcpy((dst), at, (bytes)); at += (bytes); } while(0)
+
+size_t dc_snapshot_write(const dc_World* world, void* out) {
+  const dc_Actors* actors = &world->actors;
+  unsigned int n = actors->count;
+  dc_SnapshotHeader header = {
+    .magic = {'D', 'C', 'S', 'S'},
+    .version = DC_SNAPSHOT_VERSION,
+    .size = dc_snapshot_size(world),
+    .actor_count = n,
+    .seed = world->seed,
+    .actor_capacity = actors->capacity,
+    .free_slot = actors->free_slot,
+    .player_slot = world->player.slot,
+    .player_generation = world->player.generation,
+    .room_x = world->room_x,
+    .room_y = world->room_y,
+    .rooms_cleared = world->rooms_cleared,
+    .events = world->events,
+    .evict_pending = world->evict_pending,
+    .floor_capacity = world->floor.capacity,
+    .floor_count = world->floor.count,
+    .effect_count = world->effects.count,
+    .cleared_count = world->floor.cleared_count
+  };
+  dc_snapshot_record_sizes(header.record_sizes);
+
+  unsigned char* at = out;
+  DC_PUT(&header, sizeof(header));
+  DC_PUT(actors->slots, sizeof(dc_ActorSlot) * actors->capacity);
+  DC_PUT(actors->slot_of, sizeof(unsigned int) * n);
+  DC_PUT(actors->position, sizeof(Vector2) * n);
+  DC_PUT(actors->velocity, sizeof(Vector2) * n);
+  DC_PUT(actors->time_until_next_frame, sizeof(float) * n);
+  DC_PUT(actors->iframe_time_remaining, sizeof(float) * n);
+  DC_PUT(actors->anim, sizeof(dc_Anim) * n);
+  DC_PUT(actors->health, sizeof(dc_Health) * n);
+  DC_PUT(actors->collider, sizeof(dc_Collider) * n);
+  DC_PUT(actors->ai, sizeof(dc_AiKind) * n);
+  DC_PUT(actors->should_be_freed, sizeof(bool) * n);
+  DC_PUT(actors->sprite, sizeof(dc_Sprite) * n);
+  DC_PUT(world->floor.keys, sizeof(uint32_t) * world->floor.capacity);
+  DC_PUT(world->floor.rooms, sizeof(dc_Room) * world->floor.capacity);
+  DC_PUT(world->floor.cleared, sizeof(uint32_t) * world->floor.cleared_count);
+  for(unsigned int i = 0; i < world->effects.count; i++) DC_PUT(dc_Effects_at_const(&world->effects, i), sizeof(dc_Effect));
+  return at - (unsigned char*)out;
+}
+
+// everything in the handle slots that would send an index out of bounds or tangle the free list.
+// a slot's live when its dense index points back at it, every other slot has to be on the free
+// list exactly once, and the player handle can be stale but can't land on a free slot
+static bool dc_snapshot_slots_valid(const dc_SnapshotHeader* header, const unsigned char* slots, const unsigned char* slot_of) {
+  unsigned int capacity = header->actor_capacity, n = header->actor_count;
+  if(header->free_slot > capacity) return false;
+  for(unsigned int a = 0; a < n; a++) {
+    unsigned int slot;
+    dc_ActorSlot s;
+    memcpy(&slot, slot_of + sizeof(unsigned int) * a, sizeof(slot));
+    if(slot >= capacity) return false;
+    memcpy(&s, slots + sizeof(dc_ActorSlot) * slot, sizeof(s));
+    if(s.dense != a) return false;
+  }
+  unsigned int free_count = 0;
+  for(unsigned int slot = header->free_slot; slot != capacity; free_count++) {
+    dc_ActorSlot s;
+    memcpy(&s, slots + sizeof(dc_ActorSlot) * slot, sizeof(s));
+    if(free_count == capacity - n || s.next_free > capacity) return false;
+    if(s.dense < n) {
+      unsigned int live;
+      memcpy(&live, slot_of + sizeof(unsigned int) * s.dense, sizeof(live));
+      if(live == slot) return false;
+    }
+    slot = s.next_free;
+  }
+  if(free_count != capacity - n) return false;
+  if(header->player_generation != 0) {
+    if(header->player_slot >= capacity) return false;
+    dc_ActorSlot s;
+    memcpy(&s, slots + sizeof(dc_ActorSlot) * header->player_slot, sizeof(s));
+    if(s.generation == header->player_generation) {
+      unsigned int live;
+      if(s.dense >= n) return false;
+      memcpy(&live, slot_of + sizeof(unsigned int) * s.dense, sizeof(live));
+      if(live != header->player_slot) return false;
+    }
+  }
+  return true;
+}
+
+// the room we're standing in has to be on the floor, the sim never checks for it
+static bool dc_snapshot_room_valid(const dc_SnapshotHeader* header, const unsigned char* keys) {
+  if(header->room_x >= FLOOR_WIDTH || header->room_y >= FLOOR_HEIGHT || header->floor_count >= header->floor_capacity) return false;
+  uint32_t key = header->room_x | header->room_y << 16;
+  for(unsigned int i = 0; i < header->floor_capacity; i++) {
+    uint32_t k;
+    memcpy(&k, keys + sizeof(uint32_t) * i, sizeof(k));
+    if(k == key) return true;
+  }
+  return false;
+}
+
+bool dc_snapshot_read(dc_World* world, const void* data, size_t size) {
+  dc_SnapshotHeader header;
+  if(size < sizeof(header)) return false;
+  memcpy(&header, data, sizeof(header));
+  uint16_t sizes[9];
+  dc_snapshot_record_sizes(sizes);
+  if(memcmp(header.magic, "DCSS", 4) != 0 || header.version != DC_SNAPSHOT_VERSION || memcmp(header.record_sizes, sizes, sizeof(sizes)) != 0) return false;
+  if(header.actor_count > header.actor_capacity || header.effect_count > DC_EFFECTS_CAPACITY || header.floor_capacity == 0 || (header.floor_capacity & (header.floor_capacity - 1)) != 0) return false;
+  if(header.cleared_count > DC_FLOOR_CLEARED_MAX) return false;
+  if(header.size != size || size != dc_snapshot_expected_size(header.actor_count, header.actor_capacity, header.floor_capacity, header.cleared_count, header.effect_count)) return false;
+  // past here the header and sizes agree, so every array is where we think it is
+  const unsigned char* slots = (const unsigned char*)data + sizeof(header);
+  const unsigned char* slot_of = slots + sizeof(dc_ActorSlot) * header.actor_capacity;
+  const unsigned char* keys = slots + sizeof(dc_ActorSlot) * header.actor_capacity + dc_snapshot_actor_size() * header.actor_count;
+  if(!dc_snapshot_slots_valid(&header, slots, slot_of) || !dc_snapshot_room_valid(&header, keys)) return false;
+
+  dc_Actors* actors = &world->actors;
+  unsigned int n = header.actor_count;
+  dc_Actors_reserve(actors, header.actor_capacity);
+  const unsigned char* at = (const unsigned char*)data + sizeof(header);
+  DC_GET(actors->slots, sizeof(dc_ActorSlot) * header.actor_capacity);
+  // if our arrays are bigger than the snapshot's, the slots past its end go back to how they
+  // look straight after a grow. its free list ends on the first of them, so they chain on
+  for(unsigned int s = header.actor_capacity; s < actors->capacity; s++) {
+    actors->slots[s].generation = 1;
+    actors->slots[s].next_free = s + 1;
+  }
+  DC_GET(actors->slot_of, sizeof(unsigned int) * n);
+  DC_GET(actors->position, sizeof(Vector2) * n);
+  DC_GET(actors->velocity, sizeof(Vector2) * n);
+  DC_GET(actors->time_until_next_frame, sizeof(float) * n);
+  DC_GET(actors->iframe_time_remaining, sizeof(float) * n);
+  DC_GET(actors->anim, sizeof(dc_Anim) * n);
+  DC_GET(actors->health, sizeof(dc_Health) * n);
+  DC_GET(actors->collider, sizeof(dc_Collider) * n);
+  DC_GET(actors->ai, sizeof(dc_AiKind) * n);
+  DC_GET(actors->should_be_freed, sizeof(bool) * n);
+  DC_GET(actors->sprite, sizeof(dc_Sprite) * n);
+  actors->count = n;
+  actors->free_slot = header.free_slot;
+
+  if(world->floor.capacity != header.floor_capacity) {
+    dc_Floor_free(&world->floor);
+    dc_Floor_init(&world->floor, header.floor_capacity);
+  }
+  DC_GET(world->floor.keys, sizeof(uint32_t) * header.floor_capacity);
+  DC_GET(world->floor.rooms, sizeof(dc_Room) * header.floor_capacity);
+  world->floor.count = header.floor_count;
+  DC_GET(world->floor.cleared, sizeof(uint32_t) * header.cleared_count);
+  world->floor.cleared_count = header.cleared_count;
+  world->effects.head = 0;
+  world->effects.count = header.effect_count;
+  DC_GET(world->effects.items, sizeof(dc_Effect) * header.effect_count);
+
+  world->seed = header.seed;
+  world->player = (dc_Handle){header.player_slot, header.player_generation};
+  world->room_x = header.room_x;
+  world->room_y = header.room_y;
+  world->rooms_cleared = header.rooms_cleared;
+  world->events = header.events;
+  world->evict_pending = header.evict_pending;
+  // staging only ever saves work, the next few steps just redo it
+  for(unsigned int d = 0; d < 4; d++) {
+    world->staged[d].ready = false;
+  }
+  return true;
+}
+
+bool dc_snapshot_save(const dc_World* world, const char* path) {
+  size_t size = dc_snapshot_size(world);
+  void* data = malloc(size);
+  dc_snapshot_write(world, data);
+  FILE* f = fopen(path, "wb");
+  bool ok = f && fwrite(data, 1, size, f) == size;
+  if(f && fclose(f) != 0) ok = false;
+  free(data);
+  return ok;
+}
+
+bool dc_snapshot_load(dc_World* world, const char* path) {
+  FILE* f = fopen(path, "rb");
+  if(!f) return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  bool ok = false;
+  void* data = size > 0 ? malloc(size) : NULL;
+  if(data && fread(data, 1, size, f) == (size_t)size) ok = dc_snapshot_read(world, data, size);
+  free(data);
+  fclose(f);
+  return ok;
+}
+
+void dc_Rewind_init(dc_Rewind* rewind, unsigned int capacity) {
+  *rewind = (dc_Rewind){0};
+  rewind->slots = calloc(capacity, sizeof(dc_SnapshotSlot));
+  rewind->capacity = capacity;
+}
+
+void dc_Rewind_free(dc_Rewind* rewind) {
+  for(unsigned int s = 0; s < rewind->capacity; s++) {
+    free(rewind->slots[s].data);
+  }
+  free(rewind->slots);
+  *rewind = (dc_Rewind){0};
+}
+
+void dc_Rewind_push(dc_Rewind* rewind, const dc_World* world) {
+  dc_SnapshotSlot* slot = &rewind->slots[rewind->head];
+  size_t size = dc_snapshot_size(world);
+  if(size > slot->capacity) {
+    // some slack so a few more bats don't mean another realloc
+    slot->capacity = size + size / 2;
+    slot->data = realloc(slot->data, slot->capacity);
+  }
+  slot->size = dc_snapshot_write(world, slot->data);
+  rewind->head = (rewind->head + 1) % rewind->capacity;
+  if(rewind->count < rewind->capacity) rewind->count++;
+}
+
+bool dc_Rewind_back(dc_Rewind* rewind, dc_World* world, unsigned int steps) {
+  if(steps >= rewind->count) return false;
+  rewind->count -= steps;
+  rewind->head = (rewind->head + rewind->capacity - steps % rewind->capacity) % rewind->capacity;
+  const dc_SnapshotSlot* slot = &rewind->slots[(rewind->head + rewind->capacity - 1) % rewind->capacity];
+  return dc_snapshot_read(world, slot->data, slot->size);
+}
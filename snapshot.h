@@ -0,0 +1,43 @@
+#pragma once
+#include <stddef.h>
+#include "sim.h"
+
+#define DC_SNAPSHOT_VERSION 4
+
+// everything dc_World_hash covers plus what it takes to carry on from there (handle slots,
+// the floor), as a header and then the component arrays back to back. there are no pointers
+// in any of it, so it's a memcpy per array each way. the header keeps the size of every
+// record, so a snapshot from a build where one of them changed gets turned away
+size_t dc_snapshot_size(const dc_World* world);
+// out needs dc_snapshot_size(world) bytes. returns how many got written
+size_t dc_snapshot_write(const dc_World* world, void* out);
+// world has to have been through dc_World_init already, it keeps its frame_data. arrays only
+// get reallocated when the snapshot needs more room than they've got. false (and world left
+// alone) if data isn't a whole snapshot from this version and build, or if its handle slots or
+// room don't hold together
+bool dc_snapshot_read(dc_World* world, const void* data, size_t size);
+
+bool dc_snapshot_save(const dc_World* world, const char* path);
+bool dc_snapshot_load(dc_World* world, const char* path);
+
+typedef struct {
+  unsigned char* data;
+  size_t size;
+  size_t capacity;
+} dc_SnapshotSlot;
+
+// the last `capacity` snapshots. slots keep their buffers, so once they've grown to fit
+// pushing a snapshot every frame doesn't allocate
+typedef struct {
+  dc_SnapshotSlot* slots;
+  unsigned int capacity;
+  unsigned int head; // where the next push goes
+  unsigned int count;
+} dc_Rewind;
+
+void dc_Rewind_init(dc_Rewind* rewind, unsigned int capacity);
+void dc_Rewind_free(dc_Rewind* rewind);
+void dc_Rewind_push(dc_Rewind* rewind, const dc_World* world);
+// throws away the newest `steps` snapshots and loads the one before them, which stays in the
+// ring as the newest. false if there isn't that much history
+bool dc_Rewind_back(dc_Rewind* rewind, dc_World* world, unsigned int steps);
@@ -0,0 +1,194 @@
+// packs the sprite regions listed in gfx/atlas.txt into one texture so a frame never has to
+// switch textures. run by the Makefile:
+//   atlas_pack gfx/atlas.txt --header atlas.h     layout only, needs nothing but the manifest
+//   atlas_pack gfx/atlas.txt --image gfx/atlas.png   copies the pixels over from the sources
+//   atlas_pack gfx/atlas.txt --image OUT.png --placeholders gfx/oryx/
+//                                                     same, but sources under the prefix are
+//                                                     left out whether they're there or not
+// a source that isn't there (the oryx sheets aren't in the repo) gets a placeholder and a warning
+// instead, so the game still builds and runs with a checkerboard where those sprites go
+#include <raylib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_REGIONS 256
+#define PADDING 1 // keeps neighbours from bleeding in if anyone turns on filtering
+
+typedef struct {
+  char name[64];
+  char file[256]; // "-" for a solid white block, handy as the shapes texture
+  int src_x, src_y, width, height;
+  int x, y; // where it ended up in the atlas
+} Region;
+
+static Region regions[MAX_REGIONS];
+static int region_count;
+
+static int next_pow2(int n) {
+  int p = 1;
+  while(p < n) p *= 2;
+  return p;
+}
+
+static void load_manifest(const char* path) {
+  FILE* f = fopen(path, "r");
+  if(!f) {
+    fprintf(stderr, "atlas_pack: can't open %s\n", path);
+    exit(1);
+  }
+  char line[512];
+  int line_number = 0;
+  while(fgets(line, sizeof(line), f)) {
+    line_number++;
+    char* l = line;
+    while(isspace((unsigned char)*l)) l++;
+    if(*l == '#' || *l == '\0') continue;
+    if(region_count >= MAX_REGIONS) {
+      fprintf(stderr, "atlas_pack: more than %d regions in %s\n", MAX_REGIONS, path);
+      exit(1);
+    }
+    Region* r = &regions[region_count];
+    if(sscanf(l, "%63s %255s %d %d %d %d", r->name, r->file, &r->src_x, &r->src_y, &r->width, &r->height) != 6 || r->width <= 0 || r->height <= 0) {
+      fprintf(stderr, "%s:%d: expected `name file x y width height`\n", path, line_number);
+      exit(1);
+    }
+    for(int i = 0; i < region_count; i++) {
+      if(strcmp(regions[i].name, r->name) == 0) {
+        fprintf(stderr, "%s:%d: region '%s' is already defined\n", path, line_number, r->name);
+        exit(1);
+      }
+    }
+    region_count++;
+  }
+  fclose(f);
+}
+
+// shelf packing, tallest first. ties keep manifest order so the layout only changes when the
+// manifest does
+static void pack(int* atlas_width, int* atlas_height) {
+  int order[MAX_REGIONS];
+  int widest = 0;
+  for(int i = 0; i < region_count; i++) {
+    order[i] = i;
+    if(regions[i].width > widest) widest = regions[i].width;
+    for(int j = i; j > 0 && regions[order[j]].height > regions[order[j - 1]].height; j--) {
+      int t = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = t;
+    }
+  }
+
+  int width = next_pow2(widest + PADDING);
+  int x = 0, y = 0, shelf_height = 0;
+  for(int i = 0; i < region_count; i++) {
+    Region* r = &regions[order[i]];
+    if(x + r->width + PADDING > width) {
+      x = 0;
+      y += shelf_height;
+      shelf_height = 0;
+    }
+    r->x = x;
+    r->y = y;
+    x += r->width + PADDING;
+    if(r->height + PADDING > shelf_height) shelf_height = r->height + PADDING;
+  }
+  *atlas_width = width;
+  *atlas_height = next_pow2(y + shelf_height);
+}
+
+static void upper(char* out, const char* in) {
+  while(*in) *out++ = toupper((unsigned char)*in++);
+  *out = '\0';
+}
+
+static int write_header(const char* path, const char* manifest, int width, int height) {
+  FILE* f = fopen(path, "w");
+  if(!f) {
+    fprintf(stderr, "atlas_pack: can't write %s\n", path);
+    return 1;
+  }
+  fprintf(f, "// generated from %s by tools/atlas_pack.c, edit the manifest instead\n", manifest);
+  fprintf(f, "#pragma once\n\n");
+  fprintf(f, "#define DC_ATLAS_WIDTH %d\n", width);
+  fprintf(f, "#define DC_ATLAS_HEIGHT %d\n\n", height);
+  for(int i = 0; i < region_count; i++) {
+    char name[64];
+    upper(name, regions[i].name);
+    fprintf(f, "#define DC_ATLAS_%s ((Rectangle){%d, %d, %d, %d})\n", name, regions[i].x, regions[i].y, regions[i].width, regions[i].height);
+  }
+  fclose(f);
+  return 0;
+}
+
+static void blit(Image* atlas, Image src, const Region* r) {
+  unsigned char* dst = atlas->data;
+  const unsigned char* from = src.data;
+  for(int row = 0; row < r->height; row++) {
+    memcpy(dst + ((r->y + row) * atlas->width + r->x) * 4, from + ((r->src_y + row) * src.width + r->src_x) * 4, r->width * 4);
+  }
+}
+
+// magenta and black, nobody's going to mistake it for real art
+static void placeholder(Image* atlas, const Region* r) {
+  Color* dst = atlas->data;
+  for(int row = 0; row < r->height; row++) {
+    for(int col = 0; col < r->width; col++) {
+      dst[(r->y + row) * atlas->width + r->x + col] = ((row / 4 + col / 4) % 2) ? BLACK : MAGENTA;
+    }
+  }
+}
+
+static int write_image(const char* path, int width, int height, const char* placeholders) {
+  Image atlas = GenImageColor(width, height, BLANK);
+  int failed = 0;
+  for(int i = 0; i < region_count; i++) {
+    Region* r = &regions[i];
+    if(strcmp(r->file, "-") == 0) {
+      Image white = GenImageColor(r->width, r->height, WHITE);
+      blit(&atlas, white, &(Region){.width = r->width, .height = r->height, .x = r->x, .y = r->y});
+      UnloadImage(white);
+      continue;
+    }
+
+    if(placeholders && strncmp(r->file, placeholders, strlen(placeholders)) == 0) {
+      placeholder(&atlas, r);
+      continue;
+    }
+    Image src = FileExists(r->file) ? LoadImage(r->file) : (Image){0};
+    if(src.data == NULL) {
+      fprintf(stderr, "atlas_pack: warning: can't load %s, '%s' gets a placeholder\n", r->file, r->name);
+      placeholder(&atlas, r);
+      continue;
+    }
+    ImageFormat(&src, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if(r->src_x < 0 || r->src_y < 0 || r->src_x + r->width > src.width || r->src_y + r->height > src.height) {
+      fprintf(stderr, "atlas_pack: '%s' runs off the edge of %s (%dx%d)\n", r->name, r->file, src.width, src.height);
+      failed = 1;
+    } else blit(&atlas, src, r);
+    UnloadImage(src);
+  }
+
+  if(!failed && !ExportImage(atlas, path)) {
+    fprintf(stderr, "atlas_pack: can't write %s\n", path);
+    failed = 1;
+  }
+  UnloadImage(atlas);
+  return failed;
+}
+
+int main(int argc, char** argv) {
+  bool header = argc == 4 && strcmp(argv[2], "--header") == 0;
+  bool image = (argc == 4 || (argc == 6 && strcmp(argv[4], "--placeholders") == 0)) && strcmp(argv[2], "--image") == 0;
+  if(!header && !image) {
+    fprintf(stderr, "usage: %s MANIFEST --header OUT.h | --image OUT.png [--placeholders PREFIX]\n", argv[0]);
+    return 1;
+  }
+  SetTraceLogLevel(LOG_WARNING);
+  load_manifest(argv[1]);
+  int width, height;
+  pack(&width, &height);
+  if(header) return write_header(argv[3], argv[1], width, height);
+  return write_image(argv[3], width, height, argc == 6 ? argv[5] : NULL);
+}
@@ -0,0 +1,93 @@
+// bundles assets into one pack for the game to map at startup, see pack.h for the layout.
+//   pack OUT.pak FILE...
+// an entry's name is its path, or NAME=FILE packs FILE under NAME instead
+// every file is checked before anything gets written, so a missing asset fails the build
+// instead of turning into a blank texture at runtime
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../pack.h"
+
+static long file_size(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if(!f) return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+static void pad_to(FILE* out, uint64_t offset) {
+  static const unsigned char zeroes[DC_PACK_ALIGN] = {0};
+  long at = ftell(out);
+  if((uint64_t)at < offset) fwrite(zeroes, 1, offset - at, out);
+}
+
+int main(int argc, char** argv) {
+  if(argc < 3) {
+    fprintf(stderr, "usage: %s OUT.pak [NAME=]FILE...\n", argv[0]);
+    return 1;
+  }
+  unsigned int count = argc - 2;
+  dc_PackEntry* entries = calloc(count, sizeof(dc_PackEntry));
+  const char** paths = calloc(count, sizeof(const char*));
+
+  int missing = 0;
+  uint64_t offset = sizeof(dc_PackHeader) + sizeof(dc_PackEntry) * count;
+  for(unsigned int e = 0; e < count; e++) {
+    const char* path = argv[e + 2];
+    const char* equals = strchr(path, '=');
+    size_t name_length = equals ? (size_t)(equals - path) : strlen(path);
+    if(equals) path = equals + 1;
+    paths[e] = path;
+    if(name_length >= DC_PACK_NAME_LENGTH) {
+      fprintf(stderr, "pack: '%.*s' is longer than %d characters\n", (int)name_length, argv[e + 2], DC_PACK_NAME_LENGTH - 1);
+      missing++;
+      continue;
+    }
+    long size = file_size(path);
+    if(size < 0) {
+      fprintf(stderr, "pack: missing asset %s\n", path);
+      missing++;
+      continue;
+    }
+    memcpy(entries[e].name, argv[e + 2], name_length);
+    offset = (offset + DC_PACK_ALIGN - 1) / DC_PACK_ALIGN * DC_PACK_ALIGN;
+    entries[e].offset = offset;
+    entries[e].size = size;
+    offset += size;
+  }
+  if(missing) {
+    fprintf(stderr, "pack: %d asset%s missing, not writing %s\n", missing, missing == 1 ? "" : "s", argv[1]);
+    return 1;
+  }
+
+  FILE* out = fopen(argv[1], "wb");
+  if(!out) {
+    fprintf(stderr, "pack: can't write %s\n", argv[1]);
+    return 1;
+  }
+  dc_PackHeader header = {.version = DC_PACK_VERSION, .count = count};
+  memcpy(header.magic, DC_PACK_MAGIC, 4);
+  fwrite(&header, sizeof(header), 1, out);
+  fwrite(entries, sizeof(dc_PackEntry), count, out);
+
+  char buffer[1 << 16];
+  for(unsigned int e = 0; e < count; e++) {
+    pad_to(out, entries[e].offset);
+    FILE* in = fopen(paths[e], "rb");
+    size_t n;
+    while(in && (n = fread(buffer, 1, sizeof(buffer), in)) > 0) fwrite(buffer, 1, n, out);
+    if(in) fclose(in);
+  }
+  int failed = ferror(out);
+  fclose(out);
+  free(entries);
+  free(paths);
+  if(failed) {
+    fprintf(stderr, "pack: error writing %s\n", argv[1]);
+    remove(argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,33 @@
+#include <string.h>
+#include "walls.h"
+
+// [x0, x1) by [y0, y1) in cells
+static void dc_RoomGrid_fill(dc_RoomGrid* grid, int x0, int y0, int x1, int y1, unsigned char cell) {
+  for(int y = y0; y < y1; y++) {
+    memset(&grid->cells[y][x0], cell, x1 - x0);
+  }
+}
+
+void dc_RoomGrid_build(dc_RoomGrid* grid, unsigned int doors) {
+  memset(grid->cells, 0, sizeof(grid->cells));
+  // same layout dc_Room_draw puts on screen: floor between the walls, doors in the middle of
+  // each wall (the south one a tile left of centre, like the art)
+  dc_RoomGrid_fill(grid, 4, 14, 36, 28, DC_CELL_FLOOR);
+  if(doors & DC_DOOR_NORTH) dc_RoomGrid_fill(grid, 19, 9, 21, 14, DC_CELL_DOOR | 0 << DC_CELL_SIDE_SHIFT);
+  if(doors & DC_DOOR_SOUTH) dc_RoomGrid_fill(grid, 17, 28, 19, 33, DC_CELL_DOOR | 1 << DC_CELL_SIDE_SHIFT);
+  if(doors & DC_DOOR_EAST) {
+    dc_RoomGrid_fill(grid, 36, 20, 37, 25, DC_CELL_DOORWAY);
+    dc_RoomGrid_fill(grid, 37, 20, 39, 25, DC_CELL_DOOR | 2 << DC_CELL_SIDE_SHIFT);
+  }
+  if(doors & DC_DOOR_WEST) {
+    dc_RoomGrid_fill(grid, 3, 20, 4, 25, DC_CELL_DOORWAY);
+    dc_RoomGrid_fill(grid, 1, 20, 3, 25, DC_CELL_DOOR | 3 << DC_CELL_SIDE_SHIFT);
+  }
+
+  // pulled in a hair so rounding can't land a clamped actor in the wall cell next door
+  static const float inset = 0.01f;
+  grid->floor_min_x = 4 * DC_WALL_CELL_WIDTH + inset;
+  grid->floor_max_x = 36 * DC_WALL_CELL_WIDTH - inset;
+  grid->floor_min_y = 14 * DC_WALL_CELL_HEIGHT + inset;
+  grid->floor_max_y = 28 * DC_WALL_CELL_HEIGHT - inset;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "dc.h"
+
+// a room's walls and doors as a grid over the screen, so keeping an actor out of the walls is a
+// lookup or two instead of testing it against every hitbox. a cell is TILE_WIDTH/2 by
+// TILE_HEIGHT/5, which puts every wall, door and floor edge the room has on a cell boundary
+#define DC_WALL_CELL_WIDTH (TILE_WIDTH / 2)
+#define DC_WALL_CELL_HEIGHT (TILE_HEIGHT / 5)
+#define DC_WALL_COLS 40 // SCREEN_WIDTH / DC_WALL_CELL_WIDTH
+#define DC_WALL_ROWS 38 // SCREEN_HEIGHT / DC_WALL_CELL_HEIGHT, rounded up
+
+// what a cell lets through. 0 is wall, and everything off the grid is wall too
+#define DC_CELL_FLOOR 1 // anyone
+#define DC_CELL_DOORWAY 2 // the gap between the floor and a door, only the player and only once the doors are open
+#define DC_CELL_DOOR 4 // same, and stepping in goes through the door
+#define DC_CELL_SIDE_SHIFT 4 // a door cell's side is in the high bits, as the bit index of its DC_DOOR_*
+
+typedef struct {
+  unsigned char cells[DC_WALL_ROWS][DC_WALL_COLS];
+  // the floor's extent, for putting back anything that ends up somewhere it couldn't have walked to
+  float floor_min_x, floor_max_x;
+  float floor_min_y, floor_max_y;
+} dc_RoomGrid;
+
+// the walls only depend on which doors there are, so there's one grid per DC_DOOR_* combination
+// and a room just indexes them with its doors
+void dc_RoomGrid_build(dc_RoomGrid* grid, unsigned int doors);
+
+// the cell p is in, false if that's off the grid
+static inline bool dc_RoomGrid_cell(Vector2 p, int* col, int* row) {
+  // compared as floats first so huge or NaN positions never get converted
+  float c = p.x / DC_WALL_CELL_WIDTH;
+  float r = p.y / DC_WALL_CELL_HEIGHT;
+  if(!(c >= 0 && c < DC_WALL_COLS && r >= 0 && r < DC_WALL_ROWS)) return false;
+  *col = (int)c;
+  *row = (int)r;
+  return true;
+}
+
+static inline unsigned char dc_RoomGrid_at(const dc_RoomGrid* grid, Vector2 p) {
+  int col, row;
+  return dc_RoomGrid_cell(p, &col, &row) ? grid->cells[row][col] : 0;
+}